@@ -0,0 +1,63 @@
+#ifndef ASSETPACK_H
+#define ASSETPACK_H
+
+#include "atlas.h"
+
+//------------------------------------------------------------------------------------
+// Embedded Asset Pack
+//
+// tools/assetpack.c decodes assets/ and effect/ at build time and compiles the raw
+// pixels and PCM into the executable, so loading is a pointer fixup instead of a
+// PNG/MP3 decode.
+//------------------------------------------------------------------------------------
+
+#define PACK_SOUNDS(X)                          \
+    X(PACK_SOUND_HIT,      "hit.mp3")           \
+    X(PACK_SOUND_JUMP,     "jump.mp3")          \
+    X(PACK_SOUND_POINT,    "point.mp3")         \
+    X(PACK_SOUND_BG_MUSIC, "bgMusic.mp3")
+
+#define PACK_SOUND_ENUM(id, file) id,
+
+typedef enum PackSound
+{
+    PACK_SOUNDS(PACK_SOUND_ENUM)
+    PACK_SOUND_COUNT
+
+} PackSound;
+
+#undef PACK_SOUND_ENUM
+
+//------------------------------------------------------------------------------------
+// Types and Structures Definition
+//------------------------------------------------------------------------------------
+
+// RGBA8 pixels, row-major, no padding
+typedef struct PackedImage
+{
+    int width, height;
+    const unsigned char *pixels;
+
+} PackedImage;
+
+// Interleaved PCM, same fields as raylib's Wave
+typedef struct PackedWave
+{
+    unsigned int sampleCount;           // Samples over all channels
+    unsigned int sampleRate;
+    unsigned int sampleSize;            // Bits per sample
+    unsigned int channels;
+    const void *samples;
+
+} PackedWave;
+
+typedef struct AssetPack
+{
+    PackedImage atlas;                  // Sprite rectangles are in atlas_rects.h
+    PackedWave sounds[PACK_SOUND_COUNT];
+
+} AssetPack;
+
+extern const AssetPack assetPack;
+
+#endif // ASSETPACK_H
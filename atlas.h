@@ -0,0 +1,42 @@
+#ifndef ATLAS_H
+#define ATLAS_H
+
+//------------------------------------------------------------------------------------
+// Sprite Atlas
+//
+// Every sprite lives in one texture built offline by tools/assetpack.c. The list
+// below is the single source of truth for what goes into it and in which order.
+//------------------------------------------------------------------------------------
+
+#define ATLAS_SPRITES(X)                        \
+    X(ATLAS_BACKGROUND,  "Background.png")      \
+    X(ATLAS_FOREGROUND,  "Foreground.png")      \
+    X(ATLAS_BIRD,        "Bird.png")            \
+    X(ATLAS_TOP_PIPE,    "topPipe.png")         \
+    X(ATLAS_BOTTOM_PIPE, "bottomPipe.png")      \
+    X(ATLAS_GAME_OVER,   "gameOver.png")        \
+    X(ATLAS_SCORE_BOARD, "scoreBoard.png")      \
+    X(ATLAS_TITLE,       "title.png")
+
+#define ATLAS_ENUM(id, file) id,
+
+typedef enum AtlasSprite
+{
+    ATLAS_SPRITES(ATLAS_ENUM)
+    ATLAS_COUNT
+
+} AtlasSprite;
+
+#undef ATLAS_ENUM
+
+#define ATLAS_PADDING 2                 // Transparent gap between sprites, avoids filtering bleed
+
+// Source rectangle in atlas pixels, same layout as raylib's Rectangle
+typedef struct AtlasRect
+{
+    float x, y;
+    float width, height;
+
+} AtlasRect;
+
+#endif // ATLAS_H
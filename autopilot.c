@@ -0,0 +1,321 @@
+#include <stdlib.h>
+#include <time.h>
+#include "workpool.h"
+#include "autopilot.h"
+
+//------------------------------------------------------------------------------------
+// Defines Variables
+//------------------------------------------------------------------------------------
+
+#define AUTOPILOT_PREFIX 3              // Decisions fixed per subtree, 2^3 subtree jobs
+#define AUTOPILOT_DEAD -1000000.0f      // Value of a crash, plus the steps survived before it
+
+//------------------------------------------------------------------------------------
+// Types and Structures Definition
+//------------------------------------------------------------------------------------
+
+typedef struct SearchKey
+{
+    float value;
+    int index;                          // Into the job's children
+
+} SearchKey;
+
+typedef struct SearchJob
+{
+    struct Autopilot *pilot;
+    int prefix;                         // Bit d set: flap at decision d
+
+    SimState *beam;                     // beamWidth states
+    SimState *children;                 // 2 * beamWidth states
+    SearchKey *keys;
+
+    float best;                         // Value of the best leaf found
+    long long nodes;
+
+} SearchJob;
+
+struct Autopilot
+{
+    AutopilotConfig config;
+    WorkPool *pool;
+
+    SimState root;                      // State being planned from, read by every job
+    double jobBudget;                   // Seconds each subtree may deepen, jobs share the threads
+
+    int jobCount;
+    SearchJob *jobs;
+
+    int hold;                           // Steps left on the current decision
+    long long nodes;
+};
+
+//------------------------------------------------------------------------------------
+// Module Functions Declaration (local)
+//------------------------------------------------------------------------------------
+
+static double now(void);                                            // Monotonic seconds
+static int advance(SimState *state, bool flap, int ticks);          // Play one decision, returns the steps survived
+static float evaluate(const SimState *state);                       // Higher is better for a live state
+static int compareKeys(const void *a, const void *b);               // Descending value
+static void searchSubtree(void *arg);                               // Beam search below one prefix, a pool job
+static bool plan(Autopilot *pilot, const SimState *state);          // True if flapping now leads to the best leaf
+
+//------------------------------------------------------------------------------------
+// Autopilot Functions
+//------------------------------------------------------------------------------------
+
+AutopilotConfig autopilotDefaultConfig(void)
+{
+    AutopilotConfig config;
+
+    config.beamWidth = 32;
+    config.depth = 30;                  // 1.5 s ahead, about one pipe
+    config.ticksPerDecision = 6;        // 20 decisions per second
+    config.budget = 0.004;
+    config.threads = 0;
+
+    return config;
+}
+
+Autopilot *autopilotCreate(const AutopilotConfig *config)
+{
+    Autopilot *pilot = calloc(1, sizeof(Autopilot));
+    if (pilot == NULL) return NULL;
+
+    pilot->config = *config;
+    if (pilot->config.beamWidth < 1) pilot->config.beamWidth = 1;
+    if (pilot->config.depth < 1) pilot->config.depth = 1;
+    if (pilot->config.ticksPerDecision < 1) pilot->config.ticksPerDecision = 1;
+
+    int prefix = (pilot->config.depth < AUTOPILOT_PREFIX) ? pilot->config.depth : AUTOPILOT_PREFIX;
+    int width = pilot->config.beamWidth;
+
+    int threads = (config->threads > 0) ? config->threads : workPoolDefaultThreads();
+
+    pilot->pool = workPoolCreate(threads);
+    pilot->jobCount = 1 << prefix;
+    pilot->jobBudget = pilot->config.budget * ((threads < pilot->jobCount) ? threads : pilot->jobCount) / pilot->jobCount;
+    pilot->jobs = calloc(pilot->jobCount, sizeof(SearchJob));
+    if (pilot->pool == NULL || pilot->jobs == NULL)
+    {
+        autopilotDestroy(pilot);
+        return NULL;
+    }
+
+    for (int i = 0; i < pilot->jobCount; i++)
+    {
+        SearchJob *job = &pilot->jobs[i];
+
+        job->pilot = pilot;
+        job->prefix = i;
+        job->beam = malloc(width * sizeof(SimState));
+        job->children = malloc(2 * width * sizeof(SimState));
+        job->keys = malloc(2 * width * sizeof(SearchKey));
+
+        if (job->beam == NULL || job->children == NULL || job->keys == NULL)
+        {
+            autopilotDestroy(pilot);
+            return NULL;
+        }
+    }
+
+    return pilot;
+}
+
+unsigned int autopilotInput(Autopilot *pilot, const SimState *state)
+{
+    // Title screen and game over are left to the caller, apart from the first flap
+    if (state->gameOver) return 0;
+    if (!state->bird.isJumping)
+    {
+        pilot->hold = pilot->config.ticksPerDecision - 1;
+        return SIM_INPUT_JUMP;
+    }
+
+    if (pilot->hold > 0)
+    {
+        pilot->hold--;
+        return 0;
+    }
+
+    pilot->hold = pilot->config.ticksPerDecision - 1;
+
+    return plan(pilot, state) ? SIM_INPUT_JUMP : 0;
+}
+
+long long autopilotNodes(const Autopilot *pilot)
+{
+    return pilot->nodes;
+}
+
+void autopilotDestroy(Autopilot *pilot)
+{
+    if (pilot == NULL) return;
+
+    workPoolDestroy(pilot->pool);
+
+    if (pilot->jobs != NULL)
+    {
+        for (int i = 0; i < pilot->jobCount; i++)
+        {
+            free(pilot->jobs[i].beam);
+            free(pilot->jobs[i].children);
+            free(pilot->jobs[i].keys);
+        }
+    }
+
+    free(pilot->jobs);
+    free(pilot);
+}
+
+//------------------------------------------------------------------------------------
+// Search Functions
+//------------------------------------------------------------------------------------
+
+double now(void)
+{
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+
+    return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+int advance(SimState *state, bool flap, int ticks)
+{
+    for (int t = 0; t < ticks; t++)
+    {
+        simStep(state, (flap && t == 0) ? SIM_INPUT_JUMP : 0, SIM_DT);
+        if (state->gameOver) return t;
+    }
+
+    return ticks;
+}
+
+float evaluate(const SimState *state)
+{
+    const SimPipes *pipes = &state->pipes;
+    int next = state->pipeNext;
+
+    // Points first, then how close the hitbox centre is to the next gap's centre
+    SimReal gapCenter = (pipes->gapTop[next] + pipes->gapBottom[next]) / 2;
+    SimReal birdCenter = state->bird.y - simFromFloat(state->config.birdHeight) / 2 + SIM_REAL(10);
+
+    SimReal distance = (birdCenter > gapCenter) ? birdCenter - gapCenter : gapCenter - birdCenter;
+
+    return state->score * 1000.0f - simToFloat(distance);
+}
+
+int compareKeys(const void *a, const void *b)
+{
+    const SearchKey *keyA = a;
+    const SearchKey *keyB = b;
+
+    if (keyA->value != keyB->value) return (keyA->value < keyB->value) ? 1 : -1;
+    return keyA->index - keyB->index;                   // Stable, so results don't depend on qsort
+}
+
+void searchSubtree(void *arg)
+{
+    SearchJob *job = arg;
+    Autopilot *pilot = job->pilot;
+    const AutopilotConfig *config = &pilot->config;
+    const int ticks = config->ticksPerDecision;
+
+    int prefix = (config->depth < AUTOPILOT_PREFIX) ? config->depth : AUTOPILOT_PREFIX;
+    SimState *start = &job->beam[0];
+
+    // Jobs queued behind others on a busy pool still get their slice of the budget
+    double deadline = now() + pilot->jobBudget;
+
+    job->nodes = 0;
+    simClone(start, &pilot->root);
+
+    // Play the decisions that define this subtree
+    //------------------------------------------
+    for (int d = 0; d < prefix; d++)
+    {
+        int survived = advance(start, (job->prefix >> d) & 1, ticks);
+        job->nodes++;
+
+        if (survived < ticks)
+        {
+            job->best = AUTOPILOT_DEAD + d * ticks + survived;
+            return;
+        }
+    }
+
+    // Beam search below it until the depth or the time budget runs out
+    //------------------------------------------
+    int beamCount = 1;
+    float best = evaluate(start);
+
+    for (int level = prefix; level < config->depth && now() < deadline; level++)
+    {
+        int childCount = 0;
+        float bestDead = AUTOPILOT_DEAD - 1;
+
+        for (int b = 0; b < beamCount; b++)
+        {
+            for (int flap = 0; flap < 2; flap++)
+            {
+                SimState *child = &job->children[childCount];
+
+                simClone(child, &job->beam[b]);
+                int survived = advance(child, flap, ticks);
+                job->nodes++;
+
+                if (survived < ticks)
+                {
+                    float value = AUTOPILOT_DEAD + level * ticks + survived;
+                    if (value > bestDead) bestDead = value;
+                    continue;
+                }
+
+                job->keys[childCount].value = evaluate(child);
+                job->keys[childCount].index = childCount;
+                childCount++;
+            }
+        }
+
+        if (childCount == 0)
+        {
+            best = bestDead;
+            break;
+        }
+
+        qsort(job->keys, childCount, sizeof(SearchKey), compareKeys);
+
+        beamCount = (childCount < config->beamWidth) ? childCount : config->beamWidth;
+        for (int i = 0; i < beamCount; i++) simClone(&job->beam[i], &job->children[job->keys[i].index]);
+
+        best = job->keys[0].value;
+    }
+
+    job->best = best;
+}
+
+bool plan(Autopilot *pilot, const SimState *state)
+{
+    simClone(&pilot->root, state);
+
+    for (int i = 0; i < pilot->jobCount; i++) workPoolSubmit(pilot->pool, searchSubtree, &pilot->jobs[i]);
+    workPoolWait(pilot->pool);
+
+    // Bit 0 of the prefix is the decision being made now
+    float bestIdle = AUTOPILOT_DEAD * 2, bestFlap = AUTOPILOT_DEAD * 2;
+
+    for (int i = 0; i < pilot->jobCount; i++)
+    {
+        const SearchJob *job = &pilot->jobs[i];
+
+        pilot->nodes += job->nodes;
+        if (job->prefix & 1)
+        {
+            if (job->best > bestFlap) bestFlap = job->best;
+        }
+        else if (job->best > bestIdle) bestIdle = job->best;
+    }
+
+    return bestFlap > bestIdle;
+}
@@ -0,0 +1,42 @@
+#ifndef AUTOPILOT_H
+#define AUTOPILOT_H
+
+#include "sim.h"
+
+//------------------------------------------------------------------------------------
+// Lookahead Autopilot
+//
+// Plans flaps by beam search over cloned states, stepped with simStep so it plays by
+// the same physics and collision rules as the game. A decision is "flap now" or
+// "don't" and holds for ticksPerDecision steps. The first few decisions split the
+// tree into subtrees that are searched as worker pool jobs; each subtree gets its
+// share of the per-plan time budget and stops deepening when that runs out.
+//------------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------------
+// Types and Structures Definition
+//------------------------------------------------------------------------------------
+
+typedef struct AutopilotConfig
+{
+    int beamWidth;                      // States kept per depth in each subtree
+    int depth;                          // Decisions searched ahead
+    int ticksPerDecision;               // Simulation steps a decision holds
+    double budget;                      // Seconds one plan may take
+    int threads;                        // Worker threads, 0 picks one per spare core
+
+} AutopilotConfig;
+
+typedef struct Autopilot Autopilot;
+
+//------------------------------------------------------------------------------------
+// Module Functions Declaration
+//------------------------------------------------------------------------------------
+
+AutopilotConfig autopilotDefaultConfig(void);                       // Fits a 60 Hz frame with room to spare
+Autopilot *autopilotCreate(const AutopilotConfig *config);
+unsigned int autopilotInput(Autopilot *pilot, const SimState *state);  // SIM_INPUT_* bits for the next step, replans when due
+long long autopilotNodes(const Autopilot *pilot);                   // Nodes expanded so far, one node is a clone plus a decision's steps
+void autopilotDestroy(Autopilot *pilot);
+
+#endif // AUTOPILOT_H
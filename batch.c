@@ -0,0 +1,280 @@
+#include <stdlib.h>
+#include <stdalign.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "batch.h"
+
+//------------------------------------------------------------------------------------
+// Defines Variables
+//------------------------------------------------------------------------------------
+
+#define BATCH_EMPTY -1                  // Deque has nothing left
+#define BATCH_ABORT -2                  // Lost a race for the last job, look again
+
+//------------------------------------------------------------------------------------
+// Types and Structures Definition
+//------------------------------------------------------------------------------------
+
+typedef struct BatchEntry
+{
+    int job;
+    BatchResult result;
+
+} BatchEntry;
+
+// Chase-Lev deque without the push side: it is filled before the threads start, then
+// the owner pops from the bottom and thieves take from the top
+typedef struct BatchWorker
+{
+    alignas(64) atomic_long top;
+    alignas(64) atomic_long bottom;
+    const int *items;                   // Job indices, read-only once threads run
+
+    // Owned by the worker thread, only read after it is joined
+    alignas(64) BatchEntry *entries;
+    int entryCount;
+    int entryCapacity;
+    bool failed;                        // Result buffer could not grow
+
+    struct BatchRunner *runner;
+    int index;
+    SimRng victims;                     // Picks where a steal sweep starts
+    pthread_t thread;
+
+} BatchWorker;
+
+typedef struct BatchRunner
+{
+    const BatchJob *jobs;
+    BatchWorker *workers;
+    int workerCount;
+
+} BatchRunner;
+
+//------------------------------------------------------------------------------------
+// Module Functions Declaration (local)
+//------------------------------------------------------------------------------------
+
+static int popJob(BatchWorker *worker);                 // Owner side, bottom of the deque
+static int stealJob(BatchWorker *victim);               // Thief side, top of the deque
+static int findJob(BatchWorker *worker);                // Own deque first, then steal until every deque is empty
+static bool recordResult(BatchWorker *worker, int job, BatchResult result);
+static void *workerMain(void *arg);
+
+//------------------------------------------------------------------------------------
+// Runner Functions
+//------------------------------------------------------------------------------------
+
+int batchDefaultThreads(void)
+{
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+
+    return (cores > 0) ? (int) cores : 1;
+}
+
+bool batchRun(const BatchJob *jobs, int count, BatchResult *results, int threads)
+{
+    if (count <= 0) return true;
+    if (threads < 1) threads = batchDefaultThreads();
+    if (threads > count) threads = count;
+
+    BatchRunner runner = { jobs, NULL, threads };
+    int *items = malloc(count * sizeof(int));
+
+    runner.workers = aligned_alloc(64, threads * sizeof(BatchWorker));
+    if (items == NULL || runner.workers == NULL)
+    {
+        free(items);
+        free(runner.workers);
+        return false;
+    }
+
+    // Each worker starts with a contiguous block of jobs
+    //------------------------------------------
+    for (int i = 0; i < count; i++) items[i] = i;
+
+    for (int w = 0; w < threads; w++)
+    {
+        BatchWorker *worker = &runner.workers[w];
+        long begin = (long) count * w / threads;
+        long end = (long) count * (w + 1) / threads;
+
+        atomic_init(&worker->top, begin);
+        atomic_init(&worker->bottom, end);
+        worker->items = items;
+        worker->entries = NULL;
+        worker->entryCount = 0;
+        worker->entryCapacity = 0;
+        worker->failed = false;
+        worker->runner = &runner;
+        worker->index = w;
+        simRngSeed(&worker->victims, 0, w);
+    }
+
+    // The calling thread is worker 0; a worker that fails to start just gets robbed
+    //------------------------------------------
+    bool *started = calloc(threads, sizeof(bool));
+    if (started != NULL)
+    {
+        for (int w = 1; w < threads; w++) started[w] = (pthread_create(&runner.workers[w].thread, NULL, workerMain, &runner.workers[w]) == 0);
+    }
+
+    workerMain(&runner.workers[0]);
+
+    if (started != NULL)
+    {
+        for (int w = 1; w < threads; w++) if (started[w]) pthread_join(runner.workers[w].thread, NULL);
+    }
+
+    // Merge the per-thread buffers
+    //------------------------------------------
+    bool ok = true;
+    for (int w = 0; w < threads; w++)
+    {
+        BatchWorker *worker = &runner.workers[w];
+
+        for (int i = 0; i < worker->entryCount; i++) results[worker->entries[i].job] = worker->entries[i].result;
+        if (worker->failed) ok = false;
+
+        free(worker->entries);
+    }
+
+    free(started);
+    free(runner.workers);
+    free(items);
+
+    return ok;
+}
+
+BatchResult batchPlay(const BatchJob *job)
+{
+    SimState state;
+    BatchResult result = { 0, 0, false };
+
+    simInit(&state, &job->config);
+
+    while (result.steps < job->maxSteps)
+    {
+        unsigned int input = job->controller(&state, job->context) & SIM_INPUT_JUMP;
+
+        simStep(&state, input, SIM_DT);
+        result.steps++;
+
+        if (state.gameOver)
+        {
+            result.crashed = true;
+            break;
+        }
+    }
+
+    result.score = state.score;
+
+    return result;
+}
+
+//------------------------------------------------------------------------------------
+// Deque Functions
+//------------------------------------------------------------------------------------
+
+int popJob(BatchWorker *worker)
+{
+    long b = atomic_load_explicit(&worker->bottom, memory_order_relaxed) - 1;
+    atomic_store_explicit(&worker->bottom, b, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    long t = atomic_load_explicit(&worker->top, memory_order_relaxed);
+
+    if (t > b)
+    {
+        atomic_store_explicit(&worker->bottom, b + 1, memory_order_relaxed);
+        return BATCH_EMPTY;
+    }
+
+    int job = worker->items[b];
+
+    // Last job: race the thieves for it through top
+    if (t == b)
+    {
+        if (!atomic_compare_exchange_strong_explicit(&worker->top, &t, t + 1, memory_order_seq_cst, memory_order_relaxed)) job = BATCH_EMPTY;
+        atomic_store_explicit(&worker->bottom, b + 1, memory_order_relaxed);
+    }
+
+    return job;
+}
+
+int stealJob(BatchWorker *victim)
+{
+    long t = atomic_load_explicit(&victim->top, memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    long b = atomic_load_explicit(&victim->bottom, memory_order_acquire);
+
+    if (t >= b) return BATCH_EMPTY;
+
+    int job = victim->items[t];
+    if (!atomic_compare_exchange_strong_explicit(&victim->top, &t, t + 1, memory_order_seq_cst, memory_order_relaxed)) return BATCH_ABORT;
+
+    return job;
+}
+
+int findJob(BatchWorker *worker)
+{
+    BatchRunner *runner = worker->runner;
+
+    int job = popJob(worker);
+    if (job >= 0) return job;
+
+    // Nothing is pushed after the start, so once a full sweep finds every deque empty we are done
+    for (;;)
+    {
+        bool contended = false;
+        int start = simRngRange(&worker->victims, runner->workerCount);
+
+        for (int n = 0; n < runner->workerCount; n++)
+        {
+            BatchWorker *victim = &runner->workers[(start + n) % runner->workerCount];
+            if (victim == worker) continue;
+
+            job = stealJob(victim);
+            if (job >= 0) return job;
+            if (job == BATCH_ABORT) contended = true;
+        }
+
+        if (!contended) return BATCH_EMPTY;
+    }
+}
+
+//------------------------------------------------------------------------------------
+// Worker Thread
+//------------------------------------------------------------------------------------
+
+bool recordResult(BatchWorker *worker, int job, BatchResult result)
+{
+    if (worker->entryCount == worker->entryCapacity)
+    {
+        int capacity = (worker->entryCapacity > 0) ? worker->entryCapacity * 2 : 256;
+        BatchEntry *entries = realloc(worker->entries, capacity * sizeof(BatchEntry));
+        if (entries == NULL) return false;
+
+        worker->entries = entries;
+        worker->entryCapacity = capacity;
+    }
+
+    worker->entries[worker->entryCount].job = job;
+    worker->entries[worker->entryCount].result = result;
+    worker->entryCount++;
+
+    return true;
+}
+
+void *workerMain(void *arg)
+{
+    BatchWorker *worker = arg;
+    const BatchJob *jobs = worker->runner->jobs;
+
+    for (int job = findJob(worker); job >= 0; job = findJob(worker))
+    {
+        if (!recordResult(worker, job, batchPlay(&jobs[job]))) worker->failed = true;
+    }
+
+    return NULL;
+}
@@ -0,0 +1,47 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include "sim.h"
+
+//------------------------------------------------------------------------------------
+// Batch Episode Runner
+//
+// Plays many independent single-bird games across all cores. Every job is one game
+// with its own seed and controller. Each thread owns a work-stealing deque and a
+// result buffer, nothing is shared while games run, and the buffers are merged into
+// the caller's result array once every thread has finished.
+//------------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------------
+// Types and Structures Definition
+//------------------------------------------------------------------------------------
+
+// Returns the SIM_INPUT_* bits for the next step; context must be safe to read from any thread
+typedef unsigned int (*BatchController)(const SimState *state, void *context);
+
+typedef struct BatchJob
+{
+    SimConfig config;                   // config.seed picks the course
+    BatchController controller;
+    void *context;
+    int maxSteps;                       // Stop an episode that is still alive after this many steps
+
+} BatchJob;
+
+typedef struct BatchResult
+{
+    int score;
+    int steps;                          // Steps played, including the ones before the first flap
+    bool crashed;                       // False when the episode hit maxSteps
+
+} BatchResult;
+
+//------------------------------------------------------------------------------------
+// Module Functions Declaration
+//------------------------------------------------------------------------------------
+
+int batchDefaultThreads(void);                                                      // Online cores
+bool batchRun(const BatchJob *jobs, int count, BatchResult *results, int threads);  // results[i] belongs to jobs[i], false if threads could not start
+BatchResult batchPlay(const BatchJob *job);                                         // Play one episode on the calling thread
+
+#endif // BATCH_H
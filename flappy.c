@@ -0,0 +1,128 @@
+#include <stdlib.h>
+#include "sim.h"
+#include "flappy.h"
+
+//------------------------------------------------------------------------------------
+// Types and Structures Definition
+//------------------------------------------------------------------------------------
+
+struct FlappyEnvs
+{
+    int count;
+    SimConfig config;
+    SimState *states;
+
+};
+
+//------------------------------------------------------------------------------------
+// Module Functions Declaration (local)
+//------------------------------------------------------------------------------------
+
+static void startEpisode(SimState *state, const SimConfig *config, const SimRng *rng);  // New game already in flight
+static void observe(const SimState *state, float *observation);                         // Fill FLAPPY_OBS_SIZE floats
+
+//------------------------------------------------------------------------------------
+// Environment Functions
+//------------------------------------------------------------------------------------
+
+FlappyEnvs *flappyCreate(int count)
+{
+    if (count < 1) return NULL;
+
+    FlappyEnvs *envs = calloc(1, sizeof(FlappyEnvs));
+    if (envs == NULL) return NULL;
+
+    envs->count = count;
+    envs->config = simDefaultConfig();
+    envs->states = malloc(count * sizeof(SimState));
+    if (envs->states == NULL)
+    {
+        free(envs);
+        return NULL;
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        SimConfig config = envs->config;
+        config.seed = i;
+
+        startEpisode(&envs->states[i], &config, NULL);
+    }
+
+    return envs;
+}
+
+int flappyCount(const FlappyEnvs *envs)
+{
+    return envs->count;
+}
+
+void flappyReset(FlappyEnvs *envs, const uint64_t *seeds, float *observations)
+{
+    for (int i = 0; i < envs->count; i++)
+    {
+        SimState *state = &envs->states[i];
+        SimConfig config = state->config;
+
+        if (seeds != NULL) config.seed = seeds[i];
+
+        startEpisode(state, &config, NULL);
+        if (observations != NULL) observe(state, observations + i * FLAPPY_OBS_SIZE);
+    }
+}
+
+void flappyStep(FlappyEnvs *envs, const uint8_t *actions, float *observations, float *rewards, uint8_t *dones)
+{
+    for (int i = 0; i < envs->count; i++)
+    {
+        SimState *state = &envs->states[i];
+        int events = simStep(state, actions[i] ? SIM_INPUT_JUMP : 0, SIM_DT);
+        float reward = (events & SIM_EVENT_POINT) ? FLAPPY_REWARD_POINT : 0.0f;
+        bool done = state->gameOver;
+
+        // The next episode continues the seed's random stream, like a restart in the game
+        if (done)
+        {
+            reward = FLAPPY_REWARD_HIT;
+            startEpisode(state, &state->config, &state->rng);
+        }
+
+        observe(state, observations + i * FLAPPY_OBS_SIZE);
+        rewards[i] = reward;
+        dones[i] = done;
+    }
+}
+
+void flappyDestroy(FlappyEnvs *envs)
+{
+    if (envs == NULL) return;
+
+    free(envs->states);
+    free(envs);
+}
+
+//------------------------------------------------------------------------------------
+// Episode Functions
+//------------------------------------------------------------------------------------
+
+void startEpisode(SimState *state, const SimConfig *config, const SimRng *rng)
+{
+    SimRng keep = (rng != NULL) ? *rng : (SimRng) { 0, 0 };
+
+    simInit(state, config);
+    if (rng != NULL) state->rng = keep;
+
+    // No title screen: the bird falls from the first step whether or not it flaps
+    state->bird.isJumping = 1;
+}
+
+void observe(const SimState *state, float *observation)
+{
+    int next = state->pipeNext;
+
+    observation[FLAPPY_OBS_BIRD_Y] = simToFloat(state->bird.y);
+    observation[FLAPPY_OBS_BIRD_VELOCITY] = simToFloat(state->bird.velocity * 5);  // simStep moves y by velocity * dt * 5
+    observation[FLAPPY_OBS_PIPE_X] = simToFloat(state->pipes.x[next] - state->scroll - state->bird.x);
+    observation[FLAPPY_OBS_GAP_TOP] = simToFloat(state->pipes.gapTop[next]);
+    observation[FLAPPY_OBS_GAP_BOTTOM] = simToFloat(state->pipes.gapBottom[next]);
+}
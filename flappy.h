@@ -0,0 +1,55 @@
+#ifndef FLAPPY_H
+#define FLAPPY_H
+
+#include <stdint.h>
+
+//------------------------------------------------------------------------------------
+// libflappy: Batched Environment API
+//
+// Steps many independent games per call for training code. Every function writes
+// straight into caller-owned contiguous buffers and nothing is allocated after
+// flappyCreate. A finished game restarts on the next course of its seed inside the
+// same step, so callers never have to reset single environments.
+//
+// Handles share nothing: to use several cores, give each thread its own handle.
+//------------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------------
+// Defines Variables
+//------------------------------------------------------------------------------------
+
+#if defined(_WIN32)
+    #define FLAPPY_API __declspec(dllexport)
+#else
+    #define FLAPPY_API __attribute__((visibility("default")))
+#endif
+
+// Observation layout, FLAPPY_OBS_SIZE floats per environment (pixels, pixels per second)
+#define FLAPPY_OBS_BIRD_Y           0   // Bird y
+#define FLAPPY_OBS_BIRD_VELOCITY    1   // Bird vertical velocity, positive is down
+#define FLAPPY_OBS_PIPE_X           2   // Next unpassed pipe's left edge relative to the bird
+#define FLAPPY_OBS_GAP_TOP          3   // Top of the next gap
+#define FLAPPY_OBS_GAP_BOTTOM       4   // Bottom of the next gap
+#define FLAPPY_OBS_SIZE             5
+
+// Rewards written by flappyStep()
+#define FLAPPY_REWARD_POINT  1.0f       // Passed a pipe
+#define FLAPPY_REWARD_HIT   -1.0f       // Crashed, the episode is done
+
+//------------------------------------------------------------------------------------
+// Types and Structures Definition
+//------------------------------------------------------------------------------------
+
+typedef struct FlappyEnvs FlappyEnvs;
+
+//------------------------------------------------------------------------------------
+// Module Functions Declaration
+//------------------------------------------------------------------------------------
+
+FLAPPY_API FlappyEnvs *flappyCreate(int count);                             // count environments with the default config
+FLAPPY_API int flappyCount(const FlappyEnvs *envs);
+FLAPPY_API void flappyReset(FlappyEnvs *envs, const uint64_t *seeds, float *observations);  // seeds[count], NULL keeps the previous seeds
+FLAPPY_API void flappyStep(FlappyEnvs *envs, const uint8_t *actions, float *observations, float *rewards, uint8_t *dones);   // actions[i] != 0 flaps
+FLAPPY_API void flappyDestroy(FlappyEnvs *envs);
+
+#endif // FLAPPY_H
@@ -0,0 +1,154 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "hiscore.h"
+#include "profile.h"
+
+//------------------------------------------------------------------------------------
+// Types and Structures Definition
+//------------------------------------------------------------------------------------
+
+struct HiScoreStore
+{
+    char path[1024];
+    char tempPath[1024];
+
+    pthread_mutex_t lock;
+    pthread_cond_t changed;             // Signalled on a new best or on close
+    pthread_t writer;
+
+    int best;                           // Latest value, owned by the caller side
+    int written;                        // Last value that reached the disk
+    bool quit;
+};
+
+//------------------------------------------------------------------------------------
+// Module Functions Declaration (local)
+//------------------------------------------------------------------------------------
+
+static void *writerMain(void *arg);                         // Background writer loop
+static bool writeAtomic(HiScoreStore *store, int score);    // Temp file + rename
+
+//------------------------------------------------------------------------------------
+// Store Functions
+//------------------------------------------------------------------------------------
+
+HiScoreStore *hiScoreStoreOpen(const char *path)
+{
+    HiScoreStore *store = calloc(1, sizeof(HiScoreStore));
+    if (store == NULL) return NULL;
+
+    snprintf(store->path, sizeof(store->path), "%s", path);
+    snprintf(store->tempPath, sizeof(store->tempPath), "%s.tmp", path);
+
+    FILE *inFile = fopen(path, "r");
+    if (inFile != NULL)
+    {
+        if (fscanf(inFile, "%d", &store->best) != 1) store->best = 0;
+        fclose(inFile);
+    }
+    else
+    {
+        // First run: create the store instead of giving up
+        printf("Creating %s\n", path);
+        writeAtomic(store, 0);
+    }
+    store->written = store->best;
+
+    pthread_mutex_init(&store->lock, NULL);
+    pthread_cond_init(&store->changed, NULL);
+
+    // Without the writer nothing would reach the disk, and closing would join a thread never started
+    if (pthread_create(&store->writer, NULL, writerMain, store) != 0)
+    {
+        pthread_cond_destroy(&store->changed);
+        pthread_mutex_destroy(&store->lock);
+        free(store);
+        return NULL;
+    }
+
+    return store;
+}
+
+int hiScoreStoreGet(const HiScoreStore *store)
+{
+    if (store == NULL) return 0;
+
+    return store->best;
+}
+
+void hiScoreStoreSubmit(HiScoreStore *store, int score)
+{
+    if (store == NULL || score <= store->best) return;
+
+    pthread_mutex_lock(&store->lock);
+    store->best = score;
+    pthread_cond_signal(&store->changed);
+    pthread_mutex_unlock(&store->lock);
+}
+
+void hiScoreStoreClose(HiScoreStore *store)
+{
+    if (store == NULL) return;
+
+    pthread_mutex_lock(&store->lock);
+    store->quit = true;
+    pthread_cond_signal(&store->changed);
+    pthread_mutex_unlock(&store->lock);
+
+    pthread_join(store->writer, NULL);
+
+    pthread_cond_destroy(&store->changed);
+    pthread_mutex_destroy(&store->lock);
+    free(store);
+}
+
+//------------------------------------------------------------------------------------
+// Writer Thread
+//------------------------------------------------------------------------------------
+
+void *writerMain(void *arg)
+{
+    HiScoreStore *store = arg;
+
+    PROFILE_THREAD("hiScore writer");
+
+    pthread_mutex_lock(&store->lock);
+    for (;;)
+    {
+        while (store->best == store->written && !store->quit) pthread_cond_wait(&store->changed, &store->lock);
+        if (store->best == store->written) break;
+
+        // Several points scored while the last write was in flight collapse into one write
+        int score = store->best;
+        pthread_mutex_unlock(&store->lock);
+
+        PROFILE_BEGIN(PROFILE_HISCORE);
+        if (!writeAtomic(store, score)) printf("Could Not Write %s!\n", store->path);
+        PROFILE_END(PROFILE_HISCORE);
+
+        // A failed write is retried with the next new best rather than in a loop
+        pthread_mutex_lock(&store->lock);
+        store->written = score;
+    }
+    pthread_mutex_unlock(&store->lock);
+
+    return NULL;
+}
+
+bool writeAtomic(HiScoreStore *store, int score)
+{
+    FILE *outFile = fopen(store->tempPath, "w");
+    if (outFile == NULL) return false;
+
+    bool ok = (fprintf(outFile, "%d", score) > 0) && (fflush(outFile) == 0) && (fsync(fileno(outFile)) == 0);
+    ok = (fclose(outFile) == 0) && ok;
+
+    if (ok) ok = (rename(store->tempPath, store->path) == 0);
+    if (!ok) remove(store->tempPath);
+
+    return ok;
+}
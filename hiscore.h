@@ -0,0 +1,24 @@
+#ifndef HISCORE_H
+#define HISCORE_H
+
+//------------------------------------------------------------------------------------
+// High Score Store
+//
+// Keeps the best score on disk without blocking the caller. Submissions only update
+// an in-memory value; a background thread writes the latest one to a temp file and
+// renames it over the store, so a crash never leaves a half-written file.
+// The functions accept a NULL store (open failed) and then keep nothing.
+//------------------------------------------------------------------------------------
+
+typedef struct HiScoreStore HiScoreStore;
+
+//------------------------------------------------------------------------------------
+// Module Functions Declaration
+//------------------------------------------------------------------------------------
+
+HiScoreStore *hiScoreStoreOpen(const char *path);               // Read the store, creating it if missing; NULL on failure
+int hiScoreStoreGet(const HiScoreStore *store);                 // Best score known so far
+void hiScoreStoreSubmit(HiScoreStore *store, int score);        // Queue a write if score is a new best, never blocks on I/O
+void hiScoreStoreClose(HiScoreStore *store);                    // Flush the pending write and stop the writer
+
+#endif // HISCORE_H
@@ -0,0 +1,117 @@
+#include <stdlib.h>
+#include <pthread.h>
+#include "loader.h"
+
+//------------------------------------------------------------------------------------
+// Types and Structures Definition
+//------------------------------------------------------------------------------------
+
+typedef struct LoadTask
+{
+    struct Loader *loader;
+    int index;
+
+} LoadTask;
+
+struct Loader
+{
+    LoadJob *jobs;
+    LoadTask *tasks;
+    int count;
+
+    pthread_mutex_t lock;
+    int *ready;                         // Prepared job indices in completion order
+    int readyCount;                     // Written by workers under lock
+    int uploaded;                       // Main thread only
+};
+
+//------------------------------------------------------------------------------------
+// Module Functions Declaration (local)
+//------------------------------------------------------------------------------------
+
+static void prepareTask(void *arg);     // Worker side of a job
+
+//------------------------------------------------------------------------------------
+// Loader Functions
+//------------------------------------------------------------------------------------
+
+Loader *loaderCreate(WorkPool *pool, LoadJob *jobs, int count)
+{
+    Loader *loader = calloc(1, sizeof(Loader));
+    if (loader == NULL) return NULL;
+
+    loader->jobs = jobs;
+    loader->count = count;
+    loader->tasks = malloc(count * sizeof(LoadTask));
+    loader->ready = malloc(count * sizeof(int));
+    if (loader->tasks == NULL || loader->ready == NULL)
+    {
+        free(loader->ready);
+        free(loader->tasks);
+        free(loader);
+        return NULL;
+    }
+
+    pthread_mutex_init(&loader->lock, NULL);
+
+    for (int i = 0; i < count; i++)
+    {
+        loader->tasks[i].loader = loader;
+        loader->tasks[i].index = i;
+        workPoolSubmit(pool, prepareTask, &loader->tasks[i]);
+    }
+
+    return loader;
+}
+
+bool loaderUploadNext(Loader *loader)
+{
+    pthread_mutex_lock(&loader->lock);
+    int available = loader->readyCount;
+    pthread_mutex_unlock(&loader->lock);
+
+    if (loader->uploaded >= available) return false;
+
+    LoadJob *job = &loader->jobs[loader->ready[loader->uploaded]];
+    job->upload(job);
+    loader->uploaded++;
+
+    return true;
+}
+
+float loaderProgress(const Loader *loader)
+{
+    return (loader->count > 0) ? (float) loader->uploaded / loader->count : 1.0f;
+}
+
+bool loaderDone(const Loader *loader)
+{
+    return loader->uploaded >= loader->count;
+}
+
+void loaderDestroy(Loader *loader)
+{
+    if (loader == NULL) return;
+
+    pthread_mutex_destroy(&loader->lock);
+    free(loader->ready);
+    free(loader->tasks);
+    free(loader);
+}
+
+//------------------------------------------------------------------------------------
+// Worker Side
+//------------------------------------------------------------------------------------
+
+void prepareTask(void *arg)
+{
+    LoadTask *task = arg;
+    Loader *loader = task->loader;
+    LoadJob *job = &loader->jobs[task->index];
+
+    if (job->prepare != NULL) job->prepare(job);
+
+    pthread_mutex_lock(&loader->lock);
+    loader->ready[loader->readyCount++] = task->index;
+    pthread_mutex_unlock(&loader->lock);
+}
@@ -0,0 +1,40 @@
+#ifndef LOADER_H
+#define LOADER_H
+
+#include <stdbool.h>
+#include "workpool.h"
+
+//------------------------------------------------------------------------------------
+// Asynchronous Asset Loader
+//
+// Each job has a prepare step that runs on the worker pool (decoding, format
+// conversion) and an upload step that runs on the main thread (GPU/audio device
+// calls). The main thread keeps drawing while it drains prepared jobs.
+//------------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------------
+// Types and Structures Definition
+//------------------------------------------------------------------------------------
+
+typedef struct LoadJob
+{
+    const char *name;
+    void (*prepare)(struct LoadJob *job);       // Worker thread, may be NULL
+    void (*upload)(struct LoadJob *job);        // Main thread
+    void *data;                                 // Whatever prepare hands to upload
+
+} LoadJob;
+
+typedef struct Loader Loader;
+
+//------------------------------------------------------------------------------------
+// Module Functions Declaration
+//------------------------------------------------------------------------------------
+
+Loader *loaderCreate(WorkPool *pool, LoadJob *jobs, int count);    // Queue every prepare step, NULL without memory
+bool loaderUploadNext(Loader *loader);                              // Upload one prepared job, false if none is ready
+float loaderProgress(const Loader *loader);                         // Uploaded fraction, 0.0f to 1.0f
+bool loaderDone(const Loader *loader);                              // Every job uploaded
+void loaderDestroy(Loader *loader);
+
+#endif // LOADER_H
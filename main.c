@@ -1,83 +1,93 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <math.h>
+#include <time.h>
 #include "raylib.h"
+#include "sim.h"
+#include "assetpack.h"
+#include "atlas_rects.h"
+#include "workpool.h"
+#include "loader.h"
+#include "hiscore.h"
+#include "population.h"
+#include "replay.h"
+#include "autopilot.h"
+#include "profile.h"
 
 //------------------------------------------------------------------------------------
 // Defines Variables
 //------------------------------------------------------------------------------------
 
-#define MAX_PIPES 5
-#define DIST_PIPE 300
+#define MUSIC_CHUNK_FRAMES 4096         // Frames per streamed chunk, matches raylib's stream sub-buffer
+#define MUSIC_MAX_CHANNELS 2            // Largest stream format raylib plays, and the chunk buffer holds
+#define MUSIC_MAX_SAMPLE_BYTES 4
+#define LOAD_UPLOAD_BUDGET 0.004        // Seconds of main-thread uploads per loading screen frame
+#define LOAD_JOB_COUNT 5                // Atlas, three sound effects, music stream
+#define POPULATION_MAX 100000           // Largest --population the game accepts
+#define REPLAY_FILE "lastSession.replay"    // Every played session is recorded here
+#define PROFILE_FILE "profile.json"     // F3 writes the profiler's Chrome trace here
 
 //------------------------------------------------------------------------------------
 // Types and Structures Definition
 //------------------------------------------------------------------------------------
 
-typedef struct Map
+typedef struct Effect
 {
-    Texture2D background;
-    Texture2D foreground;
-
-    float backgroundY;
-    float foregroundY;
-
-    float scrollingBack;
-    float scrollingFore;
-    int framesCounter;
-    int framesSpeed;
+    Sound hit;
+    Sound jump;
+    Sound point;
 
-    float ceiling;
-    float ground;
+    AudioStream bgMusic;                // Streamed from the packed PCM in small chunks
+    unsigned int bgMusicCursor;         // Next sample to queue
+    bool bgMusicReady;
+    bool bgMusicPlaying;
 
-} Map;
+} Effect;
 
-typedef struct Bird
+// A scrolling layer pre-composited at its drawn scale, one repeat period wide
+typedef struct LayerCache
 {
-    Texture2D birdSprite;
-    float frameWidth;
-    float x, y;
-
-    float rotation;
-
-    int isJumping;
-    float velocity;
-    float acceleration;
-    float gravity;
+    RenderTexture2D target;
+    float period;                       // Scroll distance after which the layer repeats
+    float top;                          // Screen y of the texture's first row
 
-} Bird;
+} LayerCache;
 
-typedef struct Pipe
+typedef struct SoundJob
 {
-    Texture2D topPipe;
-    Texture2D bottomPipe;
+    PackSound id;
+    Sound *target;
+    Wave wave;                          // Converted on a worker, uploaded on the main thread
 
-    Rectangle topPipeRec;
-    Rectangle bottomPipeRec;
+} SoundJob;
 
-    float x, topY, bottomY;
+//------------------------------------------------------------------------------------
+// Structure Variables
+//------------------------------------------------------------------------------------
 
-    bool active;
+static Effect effect;
 
-} Pipe;
+static SimState game;
+static SimState prevGame;           // State before the last step, drawing interpolates from it
 
-typedef struct Effect
-{
-    Sound hit;
-    Sound jump;
-    Sound point;
-    Sound bgMusic;
+static Population *population;      // Set by --population N, replaces the player with N scripted birds
+static SimState prevWorld;          // Population course before the last step
+static unsigned char *populationFlap;                   // Per bird input for the next step
+static int populationSize;
+static int populationRun;
 
-} Effect;
+static Replay *replay;              // Recording of this session, or the one played back with --replay
+static bool replayPlayback;
+static ReplayStatus replayStatus;
+static int replaySpeed = 1;         // Playback steps per real-time step: 1, 2 or 8
 
-//------------------------------------------------------------------------------------
-// Structure Variables
-//------------------------------------------------------------------------------------
+static Autopilot *autopilot;        // Set by --autopilot, plays instead of the keyboard
+static int autopilotOverTicks;      // Steps since the last crash, it restarts after a second
 
-static Map map;
-static Bird bird;
-static Pipe pipe[MAX_PIPES];
-static Effect effect;
+#if defined(PROFILE_ENABLED)
+static bool profileOverlay;         // F2 toggles the frame profiler overlay
+#endif
 
 //------------------------------------------------------------------------------------
 // Global Variables Declaration
@@ -85,90 +95,201 @@ static Effect effect;
 
 // Window Variables
 //------------------------------------------
-bool gameStart;
-bool gameOver;
-int gameRun;
-
 static const int screenWidth = 490;
 static const int screenHeight = 735;
 
 // Graphic Variables
 //------------------------------------------
-int currentFrame = 0;
-Texture2D gameOverSprite;
-Texture2D scoreBoard;
-Texture2D title;
-
-// Scoring and Speed Variables
+static Texture2D atlas;             // Every sprite, drawn through atlasRects[] source rectangles
+static float birdFrameWidth;
+
+static LayerCache backgroundLayer;  // Both background copies, composed once
+static LayerCache foregroundLayer;  // Both foreground copies, composed once
+static RenderTexture2D hudTexture;  // Score lines, redrawn only when a value changes
+static int hudScore = -1;
+static int hudHiScore = -1;
+static RenderTexture2D panelTexture;    // Game over panel, composed when the game ends
+static bool panelReady;
+
+// Scoring Variables
 //------------------------------------------
-static int score;
+static HiScoreStore *hiScoreStore;  // Writes new records on a background thread
 static int hiScore;
-static float speed;
-
-// Pipe Variables
-//------------------------------------------
-float topPipe_frameWidth;
-float topPipe_frameHeight;
-
-float bottomPipe_frameWidth;
-float bottomPipe_frameHeight;
-
-float topY_min;
-float topY_max;
-
-float max_x;
 
 //------------------------------------------------------------------------------------
 // Module Functions Declaration (local)
 //------------------------------------------------------------------------------------
 
 static void InitGame(void);         // Initialize game variables
-static void jump(void);             // Make character jumps
-static void drawGame(void);         // Draw graphics in the game
-static void updateGame(void);       // Update the game when a player runs the program
-
-static void loadTexture(void);      // Load game textures from image data: map, bird, pipe, etc.
-static void unloadTexture(void);    // Unload game textures from memory
-
-static void randomPipe(int i);      // Random pipes to different position
-
-static void loadSound(void);        // Load sound effects of the game
+static void drawGame(float alpha);  // Draw graphics in the game, alpha blends the last two steps
+static void updateGame(unsigned int input);   // Advance the game by one fixed simulation step
+static SimReal lerpReal(SimReal prev, SimReal curr, float alpha);                         // Blend two values for drawing
+static SimState interpolateGame(const SimState *prev, const SimState *curr, float alpha);  // Blend two steps for drawing
+
+static void drawPopulationGame(float alpha);    // Draw the shared course and every live bird
+static void updatePopulation(unsigned int input);   // Steer and step the population by one fixed step
+static void steerPopulation(void);  // Scripted controller, each bird aims a different height under the gap
+
+static void drawReplayStatus(void); // Playback speed and sync state
+static void drawProfile(void);      // Frame-time graph and phase costs, FLAPPY_PROFILE builds only
+static unsigned int autopilotDrive(void);   // Autopilot input for the next step, restarts after a crash
+
+static void loadAssets(void);       // Prepare assets on worker threads while drawing a loading screen
+static void drawLoading(float progress);                                    // Draw the loading screen
+
+static void uploadTexture(LoadJob *job);   // Upload the packed sprite atlas
+static void unloadTexture(void);    // Unload the sprite atlas
+static void drawSprite(AtlasSprite sprite, Vector2 position, float scale);  // Draw an atlas sprite
+static void drawBird(const SimState *view);                                 // Draw the current bird frame
+static void drawPipes(const SimState *view);                                // Draw the pipes that are on screen
+static void drawPopulation(const SimState *view, float alpha);              // Draw every live bird in one batch
+
+static void loadLayers(void);       // Compose the scrolling layers and create the HUD targets
+static void unloadLayers(void);     // Unload every cached layer
+static void composeLayer(LayerCache *layer, AtlasSprite sprite, float spriteY, float top);  // Draw both copies of a sprite into a cache
+static void drawLayer(const LayerCache *layer, SimReal scrolling);         // Draw the visible part of a cached layer
+static void updateCaches(const SimState *view);                             // Redraw the HUD and panel if their values changed
+static void drawCached(RenderTexture2D target, Rectangle source, Vector2 position);   // Draw part of a render texture upright
+
+static void prepareSound(LoadJob *job);    // Convert packed PCM to the device format
+static void uploadSound(LoadJob *job);     // Create a sound effect from converted PCM
+static void uploadMusic(LoadJob *job);     // Open the background music stream
 static void unloadSound(void);      // Unload sound effects
-bool IsSoundPlaying(Sound sound);   // Check if a sound is playing
 
-static void loadHiScore(void);      // Load high score
-static void recHiScore(void);       // Record new high score
+static void playMusic(void);        // Start the background track from the beginning
+static void stopMusic(void);        // Stop the background track
+static void updateMusic(void);      // Queue the next chunk of the background track when needed
+
 
 //------------------------------------------------------------------------------------
 // Program Main Entry Point
 //------------------------------------------------------------------------------------
 
-int main()
+int main(int argc, char *argv[])
 {
+    // Population mode: flappy --population N
+    //------------------------------------------
+    if (argc == 3 && strcmp(argv[1], "--population") == 0)
+    {
+        populationSize = atoi(argv[2]);
+        if (populationSize < 1) populationSize = 1;
+        if (populationSize > POPULATION_MAX) populationSize = POPULATION_MAX;
+
+        population = populationCreate(populationSize);
+        populationFlap = calloc(populationSize, 1);
+        if (population == NULL || populationFlap == NULL)
+        {
+            fprintf(stderr, "Not enough memory for %d birds\n", populationSize);
+            return 1;
+        }
+    }
+
+    // Replay playback: flappy --replay file
+    //------------------------------------------
+    if (argc == 3 && strcmp(argv[1], "--replay") == 0)
+    {
+        replay = replayLoad(argv[2]);
+        replayPlayback = true;
+        if (replay == NULL)
+        {
+            fprintf(stderr, "%s is not a replay\n", argv[2]);
+            return 1;
+        }
+    }
+
+    // Autopilot: flappy --autopilot
+    //------------------------------------------
+    if (argc == 2 && strcmp(argv[1], "--autopilot") == 0)
+    {
+        AutopilotConfig config = autopilotDefaultConfig();
+
+        autopilot = autopilotCreate(&config);
+        if (autopilot == NULL)
+        {
+            fprintf(stderr, "Could not start the autopilot\n");
+            return 1;
+        }
+    }
+
     // Initialization
     //------------------------------------------
+    PROFILE_THREAD("main");
+    SetConfigFlags(FLAG_VSYNC_HINT);   // Present at the display rate, the simulation rate is fixed
     InitWindow(screenWidth, screenHeight, "Flappy Bird");
     InitAudioDevice();
     HideCursor();
 
-    loadTexture();
-    loadSound();
+    loadAssets();
+
+    hiScoreStore = hiScoreStoreOpen("hiScore.txt");
+    if (hiScoreStore == NULL) TraceLog(LOG_WARNING, "Could not open hiScore.txt, high scores will not be kept");
+    hiScore = hiScoreStoreGet(hiScoreStore);
+
+    TraceLog(LOG_INFO, "Assets ready %.2f ms after window creation", GetTime() * 1000.0);
 
     InitGame();
-    SetTargetFPS(60);
+    loadLayers();
+
+    // Fixed Timestep Variables
+    //------------------------------------------
+    float accumulator = 0.0f;           // Frame time not yet consumed by simulation steps
+    unsigned int input = 0;             // Key presses waiting for the next step
 
     // Main Game Loop
     //------------------------------------------
     while (!WindowShouldClose())
     {
-        drawGame();
-        updateGame();
+        PROFILE_BEGIN(PROFILE_FRAME);
+
+        if (IsKeyPressed(KEY_SPACE)) input |= SIM_INPUT_JUMP;
+        if (IsKeyPressed(KEY_ENTER)) input |= SIM_INPUT_RESTART;
+
+        if (IsKeyPressed(KEY_ONE)) replaySpeed = 1;
+        if (IsKeyPressed(KEY_TWO)) replaySpeed = 2;
+        if (IsKeyPressed(KEY_THREE)) replaySpeed = 8;
+
+#if defined(PROFILE_ENABLED)
+        if (IsKeyPressed(KEY_F2)) profileOverlay = !profileOverlay;
+        if (IsKeyPressed(KEY_F3) && !profileWriteTrace(PROFILE_FILE)) TraceLog(LOG_WARNING, "Could not write %s", PROFILE_FILE);
+#endif
+
+        // Clamp long frames (window drag, breakpoints) so we don't spiral trying to catch up
+        float speed = replayPlayback ? replaySpeed : 1;
+        accumulator += GetFrameTime() * speed;
+        if (accumulator > 0.25f * speed) accumulator = 0.25f * speed;
+
+        while (accumulator >= SIM_DT)
+        {
+            PROFILE_BEGIN(PROFILE_UPDATE);
+            updateGame(input);
+            PROFILE_END(PROFILE_UPDATE);
+
+            input = 0;
+            accumulator -= SIM_DT;
+        }
+
+        PROFILE_BEGIN(PROFILE_AUDIO);
+        updateMusic();
+        PROFILE_END(PROFILE_AUDIO);
+
+        PROFILE_BEGIN(PROFILE_DRAW);
+        drawGame(accumulator / SIM_DT);
+        PROFILE_END(PROFILE_DRAW);
+
+        PROFILE_END(PROFILE_FRAME);
     }
 
     // De-Initialization
     //------------------------------------------
+    unloadLayers();
     unloadTexture();
     unloadSound();
+    hiScoreStoreClose(hiScoreStore);
+    if (!replayPlayback && replay != NULL && !replaySave(replay, REPLAY_FILE)) TraceLog(LOG_WARNING, "Could not save %s", REPLAY_FILE);
+    replayDestroy(replay);
+    autopilotDestroy(autopilot);
+    populationDestroy(population);
+    free(populationFlap);
 
     CloseAudioDevice();
     CloseWindow();
@@ -182,374 +303,625 @@ int main()
 
 void InitGame(void)
 {
-    // Main game, Score, and Sound
-    //------------------------------------------
-    gameStart = true;
-    gameOver = false;
-    gameRun = 0;
-
-    score = 0;
-    speed = 3.0;
-    loadHiScore();
-    PlaySound(effect.bgMusic);
-
-    // Map
-    //------------------------------------------
-    map.backgroundY = -500;
-    map.foregroundY = 630;
-
-    map.scrollingBack = 0.0f;
-    map.scrollingFore = 0.0f;
-    map.framesCounter = 0;
-    map.framesSpeed = 8;
-
-    map.ceiling = 28.0f;
-    map.ground = 625.0f;
+    SimConfig config = simDefaultConfig();
 
-    // Bird
+    // Hitboxes follow the packed sprites
     //------------------------------------------
-    bird.frameWidth = (bird.birdSprite.width / 3);
+    birdFrameWidth = (int) (atlasRects[ATLAS_BIRD].width / 3);
 
-    bird.x = 220.0f;
-    bird.y = 362.5f;
+    config.backgroundWidth = atlasRects[ATLAS_BACKGROUND].width;
+    config.foregroundWidth = atlasRects[ATLAS_FOREGROUND].width;
+    config.foregroundHeight = atlasRects[ATLAS_FOREGROUND].height;
+    config.birdFrameWidth = birdFrameWidth;
+    config.birdHeight = atlasRects[ATLAS_BIRD].height;
+    config.pipeWidth = atlasRects[ATLAS_TOP_PIPE].width * 2.5f;
+    config.pipeHeight = atlasRects[ATLAS_TOP_PIPE].height * 2.5f;
 
-    bird.rotation = 0.0f;
+    config.seed = (unsigned int) time(NULL);            // A new course every launch
 
-    bird.isJumping = 0;
-    bird.velocity = 0.0f;
-    bird.acceleration = 0.0f;
-    bird.gravity = 100.0f;
-
-    // Pipes
-    //------------------------------------------
-    topPipe_frameWidth = (float) pipe[0].topPipe.width * 2.5;
-    topPipe_frameHeight = (float) pipe[0].topPipe.height * 2.5;
+    // Playback runs the recorded config, which also carries the recorded seed
+    if (replayPlayback) config = *replayConfig(replay);
+    else if (population == NULL) replay = replayCreate(&config);
 
-    bottomPipe_frameWidth = (float) pipe[0].bottomPipe.width * 2.5;
-    bottomPipe_frameHeight = (float) pipe[0].bottomPipe.height * 2.5;
+    simInit(&game, &config);
+    prevGame = game;
 
-    topY_min = -(topPipe_frameHeight) + 145.0f;
-    topY_max = 0;
-
-    // Generate Pipes
-    for(int i = 0; i < MAX_PIPES; i++)
+    if (population != NULL)
     {
-        pipe[i].x = 900.0f + (DIST_PIPE * i);
-        randomPipe(i);
+        populationReset(population, &config, populationSize);
+        prevWorld = population->world;
+        populationRun = 1;
     }
+
+    // Sound
+    //------------------------------------------
+    playMusic();
 }
 
 //------------------------------------------------------------------------------------
-// Character's Jump Function
+// Draw Game Graphics Function
 //------------------------------------------------------------------------------------
 
-void jump(void)
+void drawGame(float alpha)
 {
-    if (IsKeyPressed(KEY_SPACE))
+    if (population != NULL)
     {
-        bird.acceleration = 10.0f;
-        bird.velocity = -bird.gravity / 1.5f;
-        bird.rotation = -35;
-    }
-    else
-    {
-        bird.acceleration += bird.gravity * GetFrameTime();
-        bird.rotation++;
+        drawPopulationGame(alpha);
+        return;
     }
 
-    if (bird.acceleration >= bird.gravity) bird.acceleration = bird.gravity;
+    SimState view = interpolateGame(&prevGame, &game, alpha);
 
-    bird.velocity += bird.acceleration * GetFrameTime() * 10;
-    bird.y += bird.velocity * GetFrameTime() * 5;
-}
+    updateCaches(&view);
 
-//------------------------------------------------------------------------------------
-// Draw Game Graphics Function
-//------------------------------------------------------------------------------------
-
-void drawGame(void)
-{
     BeginDrawing();
     ClearBackground(RAYWHITE);
-    if (!gameOver)
+    if (!view.gameOver)
     {
-        DrawTextureEx(map.background, (Vector2) {map.scrollingBack, map.backgroundY}, 0.0f, 2.5f, WHITE);
-        DrawTextureEx(map.background, (Vector2) {(float) map.background.width * 2 + map.scrollingBack, map.backgroundY},
-                      0.0f, 2.5f, WHITE);
+        drawLayer(&backgroundLayer, view.map.scrollingBack);
 
-        if(gameStart && gameRun == 0)
+        if(view.gameStart && view.gameRun == 0)
         {
-            DrawTextureEx(title, (Vector2) {screenWidth / 4.5, screenHeight / 4}, 0.0f, 3.0f, WHITE);
-            DrawTextureEx(map.foreground, (Vector2) {map.scrollingFore, map.foregroundY}, 0.0f, 2.5f, WHITE);
-            DrawTextureEx(map.foreground,
-                          (Vector2) {(float) map.foreground.width * 2 + map.scrollingFore, map.foregroundY},
-                          0.0f, 2.5f, WHITE);
-            DrawTexturePro(bird.birdSprite,
-                           (Rectangle) {currentFrame * bird.frameWidth, 0, bird.frameWidth, bird.birdSprite.height},
-                           (Rectangle) {bird.x + (bird.x / 3), bird.y, bird.frameWidth, bird.birdSprite.height},
-                           (Vector2) {bird.frameWidth, bird.birdSprite.height}, bird.rotation, WHITE);
+            drawSprite(ATLAS_TITLE, (Vector2) {screenWidth / 4.5, screenHeight / 4}, 3.0f);
+            drawLayer(&foregroundLayer, view.map.scrollingFore);
+            drawBird(&view);
+
+            PROFILE_BEGIN(PROFILE_TEXT);
             DrawText(TextFormat("Press SPACEBAR to jump"), GetScreenWidth()/2 - MeasureText(TextFormat("Press ENTER to restart"), 15)/2, screenHeight/2 + 50, 15, BLACK);
+            PROFILE_END(PROFILE_TEXT);
         }
 
-        else if(gameRun == 1)
+        else if(view.gameRun == 1)
         {
-            for (int i = 0; i < MAX_PIPES; i++)
-            {
-                DrawTextureEx(pipe[i].topPipe, (Vector2) {pipe[i].x, pipe[i].topY}, 0.0f, 2.5f, WHITE);
-                DrawTextureEx(pipe[i].bottomPipe, (Vector2) {pipe[i].x, pipe[i].bottomY}, 0.0f, 2.5f, WHITE);
-                  // Pipes Hitblock Check
-//                DrawRectangle(pipe[i].topPipeRec.x, pipe[i].topPipeRec.y, topPipe_frameWidth, topPipe_frameHeight, BLUE);
-//                DrawRectangle(pipe[i].bottomPipeRec.x, pipe[i].bottomPipeRec.y, bottomPipe_frameWidth, bottomPipe_frameHeight, MAROON);
-            }
-
-            DrawTextureEx(map.foreground, (Vector2) {map.scrollingFore, map.foregroundY}, 0.0f, 2.5f, WHITE);
-            DrawTextureEx(map.foreground,
-                          (Vector2) {(float) map.foreground.width * 2 + map.scrollingFore, map.foregroundY},
-                          0.0f, 2.5f, WHITE);
-
-            DrawTexturePro(bird.birdSprite,
-                           (Rectangle) {currentFrame * bird.frameWidth, 0, bird.frameWidth, bird.birdSprite.height},
-                           (Rectangle) {bird.x + (bird.x / 3), bird.y, bird.frameWidth, bird.birdSprite.height},
-                           (Vector2) {bird.frameWidth, bird.birdSprite.height}, bird.rotation, WHITE);
+            drawPipes(&view);
+
+            drawLayer(&foregroundLayer, view.map.scrollingFore);
+
+            drawBird(&view);
               // Bird Hitblock Check
-//            DrawRectangle(bird.x+5, bird.y - bird.birdSprite.height+15, bird.frameWidth-10, bird.birdSprite.height-10, RED);
+//            DrawRectangle(view.bird.x+5, view.bird.y - atlasRects[ATLAS_BIRD].height+15, birdFrameWidth-10, atlasRects[ATLAS_BIRD].height-10, RED);
               // Ground and Ceiling Hitblock Check
-//            DrawRectangle(bird.x, map.foregroundY, bird.frameWidth-10, map.foreground.height, PURPLE);
-//            DrawRectangle(bird.x, -50, bird.frameWidth-10, map.foreground.height, PURPLE);
+//            DrawRectangle(view.bird.x, view.map.foregroundY, birdFrameWidth-10, atlasRects[ATLAS_FOREGROUND].height, PURPLE);
+//            DrawRectangle(view.bird.x, -50, birdFrameWidth-10, atlasRects[ATLAS_FOREGROUND].height, PURPLE);
 
-            DrawText(TextFormat("Score %d", score), 5, 5, 20, BLACK);
-            DrawText(TextFormat("Hi-Score %d", hiScore), 5, 30, 20, BLACK);
+            drawCached(hudTexture, (Rectangle) {0, 0, hudTexture.texture.width, hudTexture.texture.height}, (Vector2) {5, 5});
         }
     }
     else
     {
-        DrawTextureEx(map.background, (Vector2) {map.scrollingBack, map.backgroundY}, 0.0f, 2.5f, WHITE);
+        drawLayer(&backgroundLayer, view.map.scrollingBack);
 
-        for (int i = 0; i < MAX_PIPES; i++)
-        {
-            DrawTextureEx(pipe[i].topPipe, (Vector2) {pipe[i].x, pipe[i].topY}, 0.0f, 2.5f, WHITE);
-            DrawTextureEx(pipe[i].bottomPipe, (Vector2) {pipe[i].x, pipe[i].bottomY}, 0.0f, 2.5f, WHITE);
-        }
+        drawPipes(&view);
 
-        DrawTextureEx(map.foreground, (Vector2) {map.scrollingFore, map.foregroundY}, 0.0f, 2.5f, WHITE);
+        drawLayer(&foregroundLayer, view.map.scrollingFore);
 
-        DrawTexturePro(bird.birdSprite,(Rectangle) {currentFrame * bird.frameWidth, 0, bird.frameWidth, bird.birdSprite.height},
-                       (Rectangle) {bird.x + (bird.x / 3), bird.y, bird.frameWidth, bird.birdSprite.height},
-                       (Vector2) {bird.frameWidth, bird.birdSprite.height}, bird.rotation, WHITE);
+        drawBird(&view);
 
-        DrawTextureEx(gameOverSprite, (Vector2) {screenWidth/5,screenHeight/4}, 0.0f, 3.0f, WHITE);
-
-        DrawTextureEx(scoreBoard, (Vector2) {screenWidth/5 + 2,screenHeight/3 + 15}, 0.0f, 2.5f, WHITE);
-        DrawText(TextFormat("%d",score),GetScreenWidth()/2 - MeasureText(TextFormat("%d",score),25)/2,screenHeight/3 + 60,25, BLACK);
-        DrawText(TextFormat("%d",hiScore),GetScreenWidth()/2 - MeasureText(TextFormat("%d",hiScore),25)/2, screenHeight/3 + 115,25, BLACK);
-        DrawText(TextFormat("Press ENTER to restart"), GetScreenWidth()/2 - MeasureText(TextFormat("Press ENTER to restart"), 15)/2, screenHeight/2 + 50, 15, BLACK);
+        drawCached(panelTexture, (Rectangle) {0, 0, panelTexture.texture.width, panelTexture.texture.height}, (Vector2) {0, screenHeight/4});
     }
+
+    if (replayPlayback) drawReplayStatus();
+    if (autopilot != NULL) DrawText("Autopilot", 5, screenHeight - 25, 20, MAROON);
+    drawProfile();
+
+    PROFILE_BEGIN(PROFILE_PRESENT);
     EndDrawing();
+    PROFILE_END(PROFILE_PRESENT);
+}
+
+void drawReplayStatus(void)
+{
+    const char *state = "";
+
+    if (replayStatus == REPLAY_ENDED) state = " - ended";
+    else if (replayStatus == REPLAY_DESYNC) state = TextFormat(" - DESYNC at step %d", replayTick(replay));
+
+    DrawText(TextFormat("Replay %dx (1/2/3)%s", replaySpeed, state), 5, screenHeight - 25, 20, MAROON);
+}
+
+void drawProfile(void)
+{
+#if defined(PROFILE_ENABLED)
+    if (!profileOverlay) return;
+
+    const int graphHeight = 60, left = screenWidth - PROFILE_HISTORY - 10;
+    const float graphMs = 33.3f;        // Full graph height, two 60 Hz frames
+
+    ProfileSummary summary;
+    profileSummarize(&summary);
+
+    DrawRectangle(left - 5, 5, PROFILE_HISTORY + 10, graphHeight + 30 + 15 * (PROFILE_PHASE_COUNT - 1), Fade(BLACK, 0.6f));
+
+    // One column per frame, oldest on the left, with a line at the 60 Hz budget
+    for (int i = 0; i < summary.frames; i++)
+    {
+        int height = (int) (graphHeight * ((summary.frameMs[i] < graphMs) ? summary.frameMs[i] / graphMs : 1.0f));
+        Color color = (summary.frameMs[i] > 1000.0f / 60.0f + 1.0f) ? RED : GREEN;
+
+        DrawRectangle(left + PROFILE_HISTORY - summary.frames + i, 10 + graphHeight - height, 1, height, color);
+    }
+    DrawLine(left, 10 + graphHeight / 2, left + PROFILE_HISTORY, 10 + graphHeight / 2, YELLOW);
+
+    DrawText(TextFormat("p50 %.2f  p99 %.2f ms", summary.p50, summary.p99), left, graphHeight + 15, 10, WHITE);
+    for (int i = 1; i < PROFILE_PHASE_COUNT; i++)
+    {
+        DrawText(TextFormat("%-10s %6.3f ms", profilePhaseName(i), summary.phaseMs[i]), left, graphHeight + 15 + 15 * i, 10, WHITE);
+    }
+#endif
 }
 
 //------------------------------------------------------------------------------------
 // Update Game Function
 //------------------------------------------------------------------------------------
 
-void updateGame(void)
+void updateGame(unsigned int input)
 {
-    // Local Variables
-    //------------------------------------------
-
-    Rectangle birdRec = {bird.x + 5, bird.y - bird.birdSprite.height + 15, bird.frameWidth - 10,bird.birdSprite.height - 10};
-    Rectangle topRec = {bird.x, -50, bird.frameWidth-10, map.foreground.height};
-    Rectangle bottomRec = {bird.x, map.foregroundY, bird.frameWidth-10, map.foreground.height};
+    if (population != NULL)
+    {
+        updatePopulation(input);
+        return;
+    }
 
-    if (IsSoundPlaying(effect.bgMusic) == false) PlaySound(effect.bgMusic);
+    prevGame = game;
 
-    if (!gameOver)
+    int events = 0;
+    if (replayPlayback)
     {
-        // Map Scrolling, Character and Pipe Position
-        //------------------------------------------
-        map.scrollingBack -= 0.1f;
-        map.scrollingFore -= 3.0f;
-        if (map.scrollingBack <= -(float) map.background.width * 2) map.scrollingBack = 0;
-        if (map.scrollingFore <= -(float) map.foreground.width * 2) map.scrollingFore = 0;
-
-        map.framesCounter++;
-        if (map.framesCounter >= (60 / map.framesSpeed))
-        {
-            map.framesCounter = 0;
-            currentFrame++;
+        // Past the end or a desync the game stays frozen on its last state
+        replayStatus = replayStep(replay, &game, &events);
+    }
+    else
+    {
+        if (autopilot != NULL) input = autopilotDrive();
 
-            if (currentFrame > 2) currentFrame = 0;
+        events = simStep(&game, input, SIM_DT);
+        replayRecord(replay, input, &game);
+    }
 
-            birdRec.x = (float) currentFrame * (float) bird.birdSprite.width / 3;
-        }
+    // Sound Effects
+    //------------------------------------------
+    PROFILE_BEGIN(PROFILE_AUDIO);
+    if (events & SIM_EVENT_JUMP) PlaySound(effect.jump);
+    if (events & SIM_EVENT_HIT)
+    {
+        PlaySound(effect.hit);
+        stopMusic();
+    }
+    if (events & SIM_EVENT_POINT) PlaySound(effect.point);
+    if (events & SIM_EVENT_RESTART)
+    {
+        prevGame = game;
+        playMusic();
+    }
+    PROFILE_END(PROFILE_AUDIO);
 
-        // Character jumps and falls
-        //------------------------------------------
-        if (!gameOver && IsKeyPressed(KEY_SPACE))
-        {
-            bird.isJumping = 1;
-            PlaySound(effect.jump);
-        }
+    // Scoring
+    //------------------------------------------
+    if (game.score > hiScore && !replayPlayback)              // Set and record high score
+    {
+        hiScore = game.score;
 
-        if (bird.isJumping == 1)
+        // The autopilot's best is shown in the HUD but never replaces the player's record
+        if (autopilot == NULL)
         {
-            gameRun = 1;
-            for (int i = 0; i < MAX_PIPES; i++)
-            {
-                pipe[i].x -= speed;
-                pipe[i].topPipeRec.x -= speed;
-                pipe[i].bottomPipeRec.x -= speed;
-            }
-            if (bird.y < map.ground && bird.y > map.ceiling) jump();
+            PROFILE_BEGIN(PROFILE_HISCORE);
+            hiScoreStoreSubmit(hiScoreStore, hiScore);
+            PROFILE_END(PROFILE_HISCORE);
         }
+    }
+}
 
-        // Check for Collision and Regenerate pipes
-        //------------------------------------------
+unsigned int autopilotDrive(void)
+{
+    if (!game.gameOver)
+    {
+        autopilotOverTicks = 0;
+        return autopilotInput(autopilot, &game);
+    }
 
-        // Collision between the character and map's ground/ceiling
-        if (CheckCollisionRecs(birdRec, topRec) || CheckCollisionRecs(birdRec, bottomRec))
-        {
-            PlaySound(effect.hit);
-            StopSound(effect.bgMusic);
-            gameOver = true;
-        }
+    // Leave the score board up for a second
+    autopilotOverTicks++;
+    return (autopilotOverTicks >= SIM_TICK_RATE) ? SIM_INPUT_RESTART : 0;
+}
 
-        for(int i = 0; i < MAX_PIPES; i++)
+//------------------------------------------------------------------------------------
+// Render Interpolation Function
+//------------------------------------------------------------------------------------
+
+SimReal lerpReal(SimReal prev, SimReal curr, float alpha)
+{
+    return prev + simFromFloat(simToFloat(curr - prev) * alpha);
+}
+
+static SimReal lerpWrapped(SimReal prev, SimReal curr, float alpha, SimReal wrap)
+{
+    // A jump of more than half the wrap distance means the value wrapped or was reset this step
+    if (prev - curr > wrap / 2 || curr - prev > wrap / 2) return curr;
+    return lerpReal(prev, curr, alpha);
+}
+
+SimState interpolateGame(const SimState *prev, const SimState *curr, float alpha)
+{
+    SimState view = *curr;
+
+    view.bird.y = lerpReal(prev->bird.y, curr->bird.y, alpha);
+    view.bird.rotation = lerpReal(prev->bird.rotation, curr->bird.rotation, alpha);
+
+    view.map.scrollingBack = lerpWrapped(prev->map.scrollingBack, curr->map.scrollingBack, alpha, simFromFloat(curr->config.backgroundWidth) * 2);
+    view.map.scrollingFore = lerpWrapped(prev->map.scrollingFore, curr->map.scrollingFore, alpha, simFromFloat(curr->config.foregroundWidth) * 2);
+
+    // The scroll only goes backwards when the course coordinates were rebased
+    if (curr->scroll >= prev->scroll) view.scroll = lerpReal(prev->scroll, curr->scroll, alpha);
+
+    return view;
+}
+
+//------------------------------------------------------------------------------------
+// Population Mode Functions
+//------------------------------------------------------------------------------------
+
+void drawPopulationGame(float alpha)
+{
+    SimState view = interpolateGame(&prevWorld, &population->world, alpha);
+
+    BeginDrawing();
+    ClearBackground(RAYWHITE);
+
+    drawLayer(&backgroundLayer, view.map.scrollingBack);
+
+    drawPipes(&view);
+
+    drawLayer(&foregroundLayer, view.map.scrollingFore);
+
+    drawPopulation(&view, alpha);
+
+    DrawText(TextFormat("Score %d", view.score), 5, 5, 20, BLACK);
+    DrawText(TextFormat("Alive %d/%d", population->alive, population->count), 5, 30, 20, BLACK);
+    DrawText(TextFormat("Run %d", populationRun), 5, 55, 20, BLACK);
+    drawProfile();
+
+    PROFILE_BEGIN(PROFILE_PRESENT);
+    EndDrawing();
+    PROFILE_END(PROFILE_PRESENT);
+}
+
+void drawPopulation(const SimState *view, float alpha)
+{
+    AtlasRect sheet = atlasRects[ATLAS_BIRD];
+    Rectangle source = {sheet.x + view->currentFrame * birdFrameWidth, sheet.y, birdFrameWidth, sheet.height};
+    float x = simToFloat(view->bird.x) + (simToFloat(view->bird.x) / 3);
+
+    // Same texture and no state change between quads, so raylib batches the whole
+    // population into one draw call per batch buffer
+    for (int i = 0; i < population->alive; i++)
+    {
+        float y = simToFloat(lerpReal(population->prevY[i], population->y[i], alpha));
+
+        DrawTexturePro(atlas, source, (Rectangle) {x, y, birdFrameWidth, sheet.height},
+                       (Vector2) {birdFrameWidth, sheet.height}, simToFloat(population->rotation[i]), WHITE);
+    }
+}
+
+void updatePopulation(unsigned int input)
+{
+    // A new course once everyone is down, or on request
+    if (population->alive == 0 || (input & SIM_INPUT_RESTART))
+    {
+        SimConfig config = population->world.config;
+        config.seed++;
+
+        populationReset(population, &config, populationSize);
+        prevWorld = population->world;
+        populationRun++;
+        return;
+    }
+
+    steerPopulation();
+
+    prevWorld = population->world;
+    int events = populationStep(population, populationFlap, SIM_DT);
+
+    if (events & SIM_EVENT_POINT) PlaySound(effect.point);
+}
+
+void steerPopulation(void)
+{
+    const SimState *world = &population->world;
+    SimReal gapBottom = world->map.ground;
+
+    // Next pipe still ahead of the birds
+    for (int n = 0; n < world->config.pipeCount; n++)
+    {
+        int i = (world->pipeHead + n) % world->config.pipeCount;
+        if (world->pipes.active[i])
         {
-            // Regenerate pipes
-            if (pipe[i].x < -topPipe_frameWidth)
-            {
-                for( int j = 0; j < MAX_PIPES; j++ ) if ( pipe[j].x > max_x )max_x = pipe[j].x;     // Find maximum x of pipes
-                if ( pipe[i].x > max_x )max_x = pipe[i].x;
-                pipe[i].x = max_x + DIST_PIPE;
-                randomPipe(i);
-            }
-
-            // Collision between the character and pipes
-            if ((CheckCollisionRecs(birdRec, pipe[i].topPipeRec) || CheckCollisionRecs(birdRec, pipe[i].bottomPipeRec)) && pipe[i].active)
-            {
-                PlaySound(effect.hit);
-                StopSound(effect.bgMusic);
-                gameOver = true;
-            }
-            else if ((pipe[i].topPipeRec.x + pipe[i].topPipeRec.width < birdRec.x) && (pipe[i].bottomPipeRec.x + pipe[i].bottomPipeRec.width < bird.x) && !gameOver && pipe[i].active)
-            {
-                PlaySound(effect.point);
-                score++;
-                pipe[i].active = false;
-            }
+            gapBottom = world->pipes.gapBottom[i];
+            break;
         }
+    }
+
+    for (int i = 0; i < population->alive; i++)
+    {
+        int bird = population->id[i];
+        SimReal margin = SIM_REAL(20) + simFromInt(bird * 37 % 101);   // 20 to 120 pixels above the bottom pipe
+
+        populationFlap[bird] = (population->y[i] > gapBottom - margin) || (population->steps == 0);
+    }
+}
+
+//------------------------------------------------------------------------------------
+// Asset Loading Functions
+//------------------------------------------------------------------------------------
 
-        // Scoring and Speed
-        //------------------------------------------
-        if (score % 5 == 0 && score != 0) speed += 0.005f;        // Increases speed every 5 points gain
-        if (score > hiScore)                                      // Set and record high score
+void loadAssets(void)
+{
+    static SoundJob sounds[3] =
+    {
+        { PACK_SOUND_HIT, &effect.hit, { 0 } },
+        { PACK_SOUND_JUMP, &effect.jump, { 0 } },
+        { PACK_SOUND_POINT, &effect.point, { 0 } },
+    };
+    static LoadJob jobs[LOAD_JOB_COUNT] =
+    {
+        { "atlas", NULL, uploadTexture, NULL },
+        { "hit", prepareSound, uploadSound, &sounds[0] },
+        { "jump", prepareSound, uploadSound, &sounds[1] },
+        { "point", prepareSound, uploadSound, &sounds[2] },
+        { "bgMusic", NULL, uploadMusic, NULL },
+    };
+
+    // Without worker threads (NULL pool) the jobs are prepared inline by loaderCreate
+    WorkPool *pool = workPoolCreate(workPoolDefaultThreads());
+    Loader *loader = loaderCreate(pool, jobs, LOAD_JOB_COUNT);
+
+    // No memory for the loader: prepare and upload each job in turn, without a loading screen
+    if (loader == NULL)
+    {
+        workPoolDestroy(pool);
+        for (int i = 0; i < LOAD_JOB_COUNT; i++)
         {
-            hiScore = score;
-            recHiScore();
+            if (jobs[i].prepare != NULL) jobs[i].prepare(&jobs[i]);
+            jobs[i].upload(&jobs[i]);
         }
+        return;
     }
-    else
+
+    // Upload whatever the workers finished, within a per-frame budget, and keep drawing
+    while (!loaderDone(loader) && !WindowShouldClose())
     {
-        // Game Over
-        //------------------------------------------
-        if (bird.rotation <= 30) bird.rotation += 4;
-        bird.acceleration += bird.gravity * GetFrameTime();
+        double start = GetTime();
+        while ((GetTime() - start) < LOAD_UPLOAD_BUDGET && loaderUploadNext(loader)) { }
 
-        if (bird.acceleration >= bird.gravity) bird.acceleration = bird.gravity;
+        drawLoading(loaderProgress(loader));
+    }
 
-        bird.velocity += bird.acceleration * GetFrameTime() * 10;
-        bird.y += bird.velocity * GetFrameTime() * 5;
+    // Closing mid-load still uploads the rest, so unloading stays symmetric
+    workPoolWait(pool);
+    while (loaderUploadNext(loader)) { }
 
-        if (CheckCollisionRecs(birdRec, bottomRec)) bird.y = bottomRec.y + 15;
+    loaderDestroy(loader);
+    workPoolDestroy(pool);
+}
 
-        // Restart the Game
-        //------------------------------------------
-        if (IsKeyPressed(KEY_ENTER)) InitGame();
-    }
+void drawLoading(float progress)
+{
+    const int barWidth = screenWidth - 120;
+
+    BeginDrawing();
+    ClearBackground(RAYWHITE);
+    DrawText("Loading", screenWidth/2 - MeasureText("Loading", 20)/2, screenHeight/2 - 40, 20, BLACK);
+    DrawRectangleLines(60, screenHeight/2, barWidth, 20, DARKGRAY);
+    DrawRectangle(62, screenHeight/2 + 2, (int) ((barWidth - 4) * progress), 16, DARKGRAY);
+    EndDrawing();
 }
 
 //------------------------------------------------------------------------------------
 // Game Textures Functions
 //------------------------------------------------------------------------------------
 
-void loadTexture(void)
+void uploadTexture(LoadJob *job)
 {
-    static const char backgroundPath[] = "/Users/neneprm/Desktop/C/FlappyBird/assets/background.png";
-    static const char foregroundPath[] = "/Users/neneprm/Desktop/C/FlappyBird/assets/foreground.png";
-    static const char birdPath[] = "/Users/neneprm/Desktop/C/FlappyBird/assets/bird.png";
-    static const char topPipePath[] = "/Users/neneprm/Desktop/C/FlappyBird/assets/topPipe.png";
-    static const char bottomPipePath[] = "/Users/neneprm/Desktop/C/FlappyBird/assets/bottomPipe.png";
-    static const char gameOverPath[] = "/Users/neneprm/Desktop/C/FlappyBird/assets/gameOver.png";
-    static const char scoreBoardPath[] = "/Users/neneprm/Desktop/C/FlappyBird/assets/scoreBoard.png";
-    static const char titlePath[] = "/Users/neneprm/Desktop/C/FlappyBird/assets/title.png";
+    (void) job;
 
-    map.background = LoadTexture(backgroundPath);
-    map.foreground = LoadTexture(foregroundPath);
-    bird.birdSprite = LoadTexture(birdPath);
-    for (int i = 0; i < MAX_PIPES; i++)
-    {
-        pipe[i].topPipe = LoadTexture(topPipePath);
-        pipe[i].bottomPipe = LoadTexture(bottomPipePath);
-    }
-    gameOverSprite = LoadTexture(gameOverPath);
-    scoreBoard = LoadTexture(scoreBoardPath);
-    title = LoadTexture(titlePath);
+    Image image = { (void *) assetPack.atlas.pixels, assetPack.atlas.width, assetPack.atlas.height, 1, UNCOMPRESSED_R8G8B8A8 };
+
+    atlas = LoadTextureFromImage(image);
 }
 
 void unloadTexture(void)
 {
-    UnloadTexture(map.background);
-    UnloadTexture(map.foreground);
-    UnloadTexture(bird.birdSprite);
-    for (int i = 0; i < MAX_PIPES; i++)
+    UnloadTexture(atlas);
+}
+
+void drawSprite(AtlasSprite sprite, Vector2 position, float scale)
+{
+    AtlasRect source = atlasRects[sprite];
+
+    DrawTexturePro(atlas, (Rectangle) {source.x, source.y, source.width, source.height},
+                   (Rectangle) {position.x, position.y, source.width * scale, source.height * scale},
+                   (Vector2) {0, 0}, 0.0f, WHITE);
+}
+
+void drawBird(const SimState *view)
+{
+    AtlasRect sheet = atlasRects[ATLAS_BIRD];
+
+    DrawTexturePro(atlas,
+                   (Rectangle) {sheet.x + view->currentFrame * birdFrameWidth, sheet.y, birdFrameWidth, sheet.height},
+                   (Rectangle) {simToFloat(view->bird.x) + (simToFloat(view->bird.x) / 3), simToFloat(view->bird.y), birdFrameWidth, sheet.height},
+                   (Vector2) {birdFrameWidth, sheet.height}, simToFloat(view->bird.rotation), WHITE);
+}
+
+void drawPipes(const SimState *view)
+{
+    // Walk the ring from the oldest pipe and stop at the first one past the right edge
+    for (int n = 0; n < view->config.pipeCount; n++)
     {
-        UnloadTexture(pipe[i].topPipe);
-        UnloadTexture(pipe[i].bottomPipe);
+        int i = (view->pipeHead + n) % view->config.pipeCount;
+        float x = simToFloat(view->pipes.x[i] - view->scroll);
+        float topY = simToFloat(view->pipes.gapTop[i]) - view->config.pipeHeight;
+        float bottomY = simToFloat(view->pipes.gapBottom[i]);
+
+        if (x > screenWidth) break;
+
+        drawSprite(ATLAS_TOP_PIPE, (Vector2) {x, topY}, 2.5f);
+        drawSprite(ATLAS_BOTTOM_PIPE, (Vector2) {x, bottomY}, 2.5f);
+          // Pipes Hitblock Check
+//        DrawRectangle(x, topY, view->config.pipeWidth, view->config.pipeHeight, BLUE);
+//        DrawRectangle(x, bottomY, view->config.pipeWidth, view->config.pipeHeight, MAROON);
     }
-    UnloadTexture(gameOverSprite);
-    UnloadTexture(scoreBoard);
-    UnloadTexture(title);
 }
 
 //------------------------------------------------------------------------------------
-// Pipe Functions
+// Cached Layer Functions
 //------------------------------------------------------------------------------------
 
-void randomPipe(int i)
+void loadLayers(void)
+{
+    // Each scrolling layer is the same two sprite copies every frame, only offset, so
+    // they are drawn once into a strip one wrap period wide and then shifted
+    backgroundLayer.period = atlasRects[ATLAS_BACKGROUND].width * 2;
+    foregroundLayer.period = atlasRects[ATLAS_FOREGROUND].width * 2;
+
+    composeLayer(&backgroundLayer, ATLAS_BACKGROUND, simToFloat(game.map.backgroundY), 0);
+    composeLayer(&foregroundLayer, ATLAS_FOREGROUND, simToFloat(game.map.foregroundY), simToFloat(game.map.foregroundY));
+
+    hudTexture = LoadRenderTexture(screenWidth/2, 45);
+
+    // Game over sprites and text, from the top of the title to the restart line
+    float panelBottom = screenHeight/2 + 65;
+    if (screenHeight/4 + atlasRects[ATLAS_GAME_OVER].height * 3.0f > panelBottom) panelBottom = screenHeight/4 + atlasRects[ATLAS_GAME_OVER].height * 3.0f;
+    if (screenHeight/3 + 15 + atlasRects[ATLAS_SCORE_BOARD].height * 2.5f > panelBottom) panelBottom = screenHeight/3 + 15 + atlasRects[ATLAS_SCORE_BOARD].height * 2.5f;
+
+    panelTexture = LoadRenderTexture(screenWidth, (int) panelBottom - screenHeight/4);
+}
+
+void unloadLayers(void)
+{
+    UnloadRenderTexture(backgroundLayer.target);
+    UnloadRenderTexture(foregroundLayer.target);
+    UnloadRenderTexture(hudTexture);
+    UnloadRenderTexture(panelTexture);
+}
+
+void composeLayer(LayerCache *layer, AtlasSprite sprite, float spriteY, float top)
+{
+    // Only the rows that reach the screen
+    float bottom = spriteY + atlasRects[sprite].height * 2.5f;
+    if (bottom > screenHeight) bottom = screenHeight;
+
+    layer->top = top;
+    layer->target = LoadRenderTexture((int) layer->period, (int) (bottom - top));
+
+    // The copy scrolled in from the right lies over the end of the previous one
+    BeginTextureMode(layer->target);
+    ClearBackground(BLANK);
+    drawSprite(sprite, (Vector2) {-layer->period, spriteY - top}, 2.5f);
+    drawSprite(sprite, (Vector2) {0, spriteY - top}, 2.5f);
+    EndTextureMode();
+}
+
+void drawLayer(const LayerCache *layer, SimReal scrolling)
 {
-    pipe[i].topY = GetRandomValue(topY_min, topY_max);
-    pipe[i].bottomY = pipe[i].topY + 550.0f;
+    float height = layer->target.texture.height;
+    float offset = fmodf(-simToFloat(scrolling), layer->period);
+    if (offset < 0) offset += layer->period;
 
-    pipe[i].topPipeRec.x = pipe[i].x;
-    pipe[i].topPipeRec.y = pipe[i].topY;
-    pipe[i].topPipeRec.height = topPipe_frameHeight;
-    pipe[i].topPipeRec.width = topPipe_frameWidth;
+    // Split at the strip's end instead of repeat wrapping, which needs power of two sizes on GLES2
+    float first = layer->period - offset;
+    if (first > screenWidth) first = screenWidth;
 
-    pipe[i].bottomPipeRec.x = pipe[i].x;
-    pipe[i].bottomPipeRec.y = pipe[i].bottomY;
-    pipe[i].bottomPipeRec.height = bottomPipe_frameHeight;
-    pipe[i].bottomPipeRec.width = bottomPipe_frameWidth;
+    drawCached(layer->target, (Rectangle) {offset, 0, first, height}, (Vector2) {0, layer->top});
+    if (first < screenWidth) drawCached(layer->target, (Rectangle) {0, 0, screenWidth - first, height}, (Vector2) {first, layer->top});
+}
 
-    pipe[i].active = true;
+void updateCaches(const SimState *view)
+{
+    if (view->score != hudScore || hiScore != hudHiScore)
+    {
+        hudScore = view->score;
+        hudHiScore = hiScore;
+
+        PROFILE_BEGIN(PROFILE_TEXT);
+        BeginTextureMode(hudTexture);
+        ClearBackground(BLANK);
+        DrawText(TextFormat("Score %d", hudScore), 0, 0, 20, BLACK);
+        DrawText(TextFormat("Hi-Score %d", hudHiScore), 0, 25, 20, BLACK);
+        EndTextureMode();
+        PROFILE_END(PROFILE_TEXT);
+    }
+
+    if (!view->gameOver) panelReady = false;
+    else if (!panelReady)
+    {
+        // Score and hi-score are final by the first frame of the game over
+        const float top = screenHeight/4;
+
+        PROFILE_BEGIN(PROFILE_TEXT);
+        BeginTextureMode(panelTexture);
+        ClearBackground(BLANK);
+        drawSprite(ATLAS_GAME_OVER, (Vector2) {screenWidth/5, screenHeight/4 - top}, 3.0f);
+        drawSprite(ATLAS_SCORE_BOARD, (Vector2) {screenWidth/5 + 2, screenHeight/3 + 15 - top}, 2.5f);
+        DrawText(TextFormat("%d", view->score), screenWidth/2 - MeasureText(TextFormat("%d", view->score), 25)/2, screenHeight/3 + 60 - top, 25, BLACK);
+        DrawText(TextFormat("%d", hiScore), screenWidth/2 - MeasureText(TextFormat("%d", hiScore), 25)/2, screenHeight/3 + 115 - top, 25, BLACK);
+        DrawText("Press ENTER to restart", screenWidth/2 - MeasureText("Press ENTER to restart", 15)/2, screenHeight/2 + 50 - top, 15, BLACK);
+        EndTextureMode();
+        PROFILE_END(PROFILE_TEXT);
+
+        panelReady = true;
+    }
+}
+
+void drawCached(RenderTexture2D target, Rectangle source, Vector2 position)
+{
+    // Render textures are stored bottom row first: flip, and count rows from the bottom
+    Rectangle flipped = { source.x, target.texture.height - source.y - source.height, source.width, -source.height };
+
+    DrawTextureRec(target.texture, flipped, position, WHITE);
 }
 
 //------------------------------------------------------------------------------------
 // Sound Effects Functions
 //------------------------------------------------------------------------------------
 
-void loadSound(void)
+void prepareSound(LoadJob *job)
+{
+    SoundJob *sound = job->data;
+    const PackedWave *packed = &assetPack.sounds[sound->id];
+    Wave wave = { packed->sampleCount, packed->sampleRate, packed->sampleSize, packed->channels, (void *) packed->samples };
+
+    if (packed->samples == NULL) return;
+
+    // 44.1 kHz float stereo is what the mixer plays, so the upload is a plain copy
+    sound->wave = WaveCopy(wave);
+    WaveFormat(&sound->wave, 44100, 32, 2);
+}
+
+void uploadSound(LoadJob *job)
+{
+    SoundJob *sound = job->data;
+
+    if (sound->wave.data == NULL) return;
+
+    *sound->target = LoadSoundFromWave(sound->wave);
+    UnloadWave(sound->wave);
+
+    if (sound->id == PACK_SOUND_JUMP) SetSoundVolume(*sound->target, 0.3);
+}
+
+void uploadMusic(LoadJob *job)
 {
-    static const char hitPath[] = "/Users/neneprm/Desktop/C/FlappyBird/effect/hit.mp3";
-    static const char jumpPath[] = "/Users/neneprm/Desktop/C/FlappyBird/effect/jump.mp3";
-    static const char pointPath[] = "/Users/neneprm/Desktop/C/FlappyBird/effect/point.mp3";
-    static const char bgMusicPath[] = "/Users/neneprm/Desktop/C/FlappyBird/effect/bgMusic.mp3";
+    const PackedWave *music = &assetPack.sounds[PACK_SOUND_BG_MUSIC];
 
-    effect.hit = LoadSound(hitPath);
-    effect.jump = LoadSound(jumpPath);
-    effect.point = LoadSound(pointPath);
-    effect.bgMusic = LoadSound(bgMusicPath);
+    (void) job;
 
-    SetSoundVolume(effect.jump, 0.3);
+    // The streaming chunk is sized for raylib's formats, anything larger is not played
+    bool supported = (music->channels >= 1) && (music->channels <= MUSIC_MAX_CHANNELS) &&
+                     (music->sampleSize == 8 || music->sampleSize == 16 || music->sampleSize == 32);
+
+    effect.bgMusicReady = (music->samples != NULL) && (music->sampleCount > 0) && supported;
+    if ((music->samples != NULL) && !effect.bgMusicReady) TraceLog(LOG_WARNING, "Unsupported music format: %u channels, %u bits", music->channels, music->sampleSize);
+    if (effect.bgMusicReady) effect.bgMusic = InitAudioStream(music->sampleRate, music->sampleSize, music->channels);
 }
 
 void unloadSound(void)
@@ -557,34 +929,57 @@ void unloadSound(void)
     UnloadSound(effect.hit);
     UnloadSound(effect.jump);
     UnloadSound(effect.point);
-    UnloadSound(effect.bgMusic);
+    if (effect.bgMusicReady) CloseAudioStream(effect.bgMusic);
 }
 
 //------------------------------------------------------------------------------------
-// High Score Functions
+// Background Music Functions
 //------------------------------------------------------------------------------------
 
-void loadHiScore(void)
+void playMusic(void)
 {
-    FILE *inFile;
-    inFile = fopen("hiScore.txt", "r");
-    if (inFile == NULL)
-    {
-        printf("Could Not Open File!\n");
-        exit(-1);
-    }
-    else
-    {
-        fscanf(inFile, "%d", &hiScore);
-        printf("%d\n",hiScore);
-    }
-    fclose(inFile);
+    if (!effect.bgMusicReady) return;
+
+    effect.bgMusicCursor = 0;
+    effect.bgMusicPlaying = true;
+    PlayAudioStream(effect.bgMusic);
 }
 
-void recHiScore(void)
+void stopMusic(void)
 {
-    FILE *outFile;
-    outFile = fopen("hiScore.txt", "w");
-    if (outFile != NULL) fprintf(outFile, "%d", hiScore);
-    fclose(outFile);
-}
\ No newline at end of file
+    if (!effect.bgMusicReady) return;
+
+    effect.bgMusicPlaying = false;
+    StopAudioStream(effect.bgMusic);
+}
+
+void updateMusic(void)
+{
+    // One chunk fills one half of raylib's double-buffered stream
+    static unsigned char chunk[MUSIC_CHUNK_FRAMES * MUSIC_MAX_CHANNELS * MUSIC_MAX_SAMPLE_BYTES];
+
+    if (!effect.bgMusicPlaying) return;
+
+    const PackedWave *music = &assetPack.sounds[PACK_SOUND_BG_MUSIC];
+    const unsigned char *samples = music->samples;
+    unsigned int sampleBytes = music->sampleSize / 8;
+    unsigned int chunkSamples = MUSIC_CHUNK_FRAMES * music->channels;
+
+    while (IsAudioStreamProcessed(effect.bgMusic))
+    {
+        // Copy up to the end of the track and wrap to the start, so the loop has no gap
+        unsigned int filled = 0;
+        while (filled < chunkSamples)
+        {
+            unsigned int count = music->sampleCount - effect.bgMusicCursor;
+            if (count > chunkSamples - filled) count = chunkSamples - filled;
+
+            memcpy(chunk + filled * sampleBytes, samples + effect.bgMusicCursor * sampleBytes, count * sampleBytes);
+            filled += count;
+            effect.bgMusicCursor += count;
+            if (effect.bgMusicCursor >= music->sampleCount) effect.bgMusicCursor = 0;
+        }
+
+        UpdateAudioStream(effect.bgMusic, chunk, chunkSamples);
+    }
+}
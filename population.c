@@ -0,0 +1,227 @@
+#include <stdlib.h>
+#include "population.h"
+
+//------------------------------------------------------------------------------------
+// Module Functions Declaration (local)
+//------------------------------------------------------------------------------------
+
+static void moveBird(Population *pop, int from, int to);           // Copy one slot over another
+static void killBirds(Population *pop);                             // Record and compact out the birds flagged in hit[]
+
+//------------------------------------------------------------------------------------
+// Population Functions
+//------------------------------------------------------------------------------------
+
+Population *populationCreate(int capacity)
+{
+    Population *pop = calloc(1, sizeof(Population));
+    if (pop == NULL) return NULL;
+
+    if (capacity < 1) capacity = 1;
+    pop->capacity = capacity;
+
+    pop->id = malloc(capacity * sizeof(int));
+    pop->y = malloc(capacity * sizeof(SimReal));
+    pop->prevY = malloc(capacity * sizeof(SimReal));
+    pop->velocity = malloc(capacity * sizeof(SimReal));
+    pop->acceleration = malloc(capacity * sizeof(SimReal));
+    pop->rotation = malloc(capacity * sizeof(SimReal));
+    pop->hit = malloc(capacity);
+    pop->scratch = malloc(capacity);
+    pop->score = malloc(capacity * sizeof(int));
+    pop->deathStep = malloc(capacity * sizeof(int));
+
+    if (pop->id == NULL || pop->y == NULL || pop->prevY == NULL || pop->velocity == NULL ||
+        pop->acceleration == NULL || pop->rotation == NULL || pop->hit == NULL ||
+        pop->scratch == NULL || pop->score == NULL || pop->deathStep == NULL)
+    {
+        populationDestroy(pop);
+        return NULL;
+    }
+
+    return pop;
+}
+
+void populationReset(Population *pop, const SimConfig *config, int count)
+{
+    SimState *world = &pop->world;
+
+    if (count < 1) count = 1;
+    if (count > pop->capacity) count = pop->capacity;
+
+    simInit(world, config);
+    world->bird.isJumping = 1;
+    world->gameRun = 1;
+
+    pop->count = count;
+    pop->alive = count;
+    pop->steps = 0;
+
+    for (int i = 0; i < count; i++)
+    {
+        pop->id[i] = i;
+        pop->y[i] = world->bird.y;
+        pop->prevY[i] = world->bird.y;
+        pop->velocity[i] = world->bird.velocity;
+        pop->acceleration[i] = world->bird.acceleration;
+        pop->rotation[i] = world->bird.rotation;
+
+        pop->score[i] = 0;
+        pop->deathStep[i] = -1;
+    }
+}
+
+int populationStep(Population *pop, const unsigned char *flap, float dt)
+{
+    SimState *world = &pop->world;
+    const SimConfig *config = &world->config;
+    const SimMap *map = &world->map;
+    const SimReal gravity = world->bird.gravity;
+    const SimReal step = simFromFloat(dt);
+    const SimReal fall = simMul(gravity, step);                     // Acceleration gained per step
+    const SimReal flapVelocity = simDiv(-gravity, SIM_REAL(1.5));
+    const SimReal birdHeight = simFromFloat(config->birdHeight);
+    int events = 0;
+
+    if (pop->alive == 0) return 0;
+
+    pop->steps++;
+    simAdvanceCourse(world, dt);
+
+    // Bird physics, same as the single bird's jump
+    //------------------------------------------
+    bool anyFlap = false;
+
+    for (int i = 0; i < pop->alive; i++)
+    {
+        SimReal y = pop->y[i];
+        pop->prevY[i] = y;
+
+        if (!(y < map->ground && y > map->ceiling)) continue;
+
+        bool up = (flap != NULL) && flap[pop->id[i]];
+        SimReal acceleration = pop->acceleration[i];
+        SimReal velocity = pop->velocity[i];
+
+        if (up)
+        {
+            acceleration = SIM_REAL(10);
+            velocity = flapVelocity;
+            pop->rotation[i] = SIM_REAL(-35);
+        }
+        else
+        {
+            acceleration += fall;
+            pop->rotation[i] += simMul(SIM_REAL(60), step);
+        }
+
+        if (acceleration >= gravity) acceleration = gravity;
+
+        velocity += simMul(acceleration, step) * 10;
+        pop->acceleration[i] = acceleration;
+        pop->velocity[i] = velocity;
+        pop->y[i] = y + simMul(velocity, step) * 5;
+
+        anyFlap |= up;
+    }
+
+    if (anyFlap) events |= SIM_EVENT_JUMP;
+
+    // Collision, every bird shares x so each obstacle is one batch test on the
+    // heights the birds had at the start of the step (as in simStep)
+    //------------------------------------------
+    simCollideBand(pop->prevY, pop->alive, simBoundsBand(world), birdHeight, pop->hit);
+
+    SimPipes *pipes = &world->pipes;
+    SimReal birdLeft = world->bird.x + SIM_REAL(5) + world->scroll;
+    SimReal birdRight = birdLeft + simFromFloat(config->birdFrameWidth) - SIM_REAL(10);
+    SimReal courseBirdX = world->bird.x + world->scroll;
+    bool passed = false;
+
+    for (int n = 0; n < config->pipeCount; n++)
+    {
+        int i = (world->pipeNext + n) % config->pipeCount;
+        SimReal pipeRight = pipes->x[i] + simFromFloat(config->pipeWidth);
+
+        if (pipes->x[i] >= birdRight) break;
+
+        if (pipes->active[i] && pipeRight > birdLeft)
+        {
+            if (simCollideBand(pop->prevY, pop->alive, simPipeBand(world, i), birdHeight, pop->scratch) > 0)
+            {
+                for (int k = 0; k < pop->alive; k++) pop->hit[k] |= pop->scratch[k];
+            }
+        }
+        else if ((pipeRight < birdLeft) && (pipeRight < courseBirdX) && pipes->active[i])
+        {
+            passed = true;
+            pipes->active[i] = false;
+            if (i == world->pipeNext) world->pipeNext = (i + 1) % config->pipeCount;
+        }
+    }
+
+    int before = pop->alive;
+    killBirds(pop);
+    if (pop->alive < before) events |= SIM_EVENT_HIT;
+
+    // Scoring, every survivor passed the same pipe
+    //------------------------------------------
+    if (passed && pop->alive > 0)
+    {
+        events |= SIM_EVENT_POINT;
+        world->score++;
+        for (int i = 0; i < pop->alive; i++) pop->score[pop->id[i]] = world->score;
+    }
+
+    if (pop->alive == 0) world->gameOver = true;
+
+    // Speed
+    //------------------------------------------
+    if (world->score % 5 == 0 && world->score != 0) world->speed += simMul(SIM_REAL(18), step);  // Increases speed every 5 points gain
+
+    return events;
+}
+
+void populationDestroy(Population *pop)
+{
+    if (pop == NULL) return;
+
+    free(pop->id);
+    free(pop->y);
+    free(pop->prevY);
+    free(pop->velocity);
+    free(pop->acceleration);
+    free(pop->rotation);
+    free(pop->hit);
+    free(pop->scratch);
+    free(pop->score);
+    free(pop->deathStep);
+    free(pop);
+}
+
+//------------------------------------------------------------------------------------
+// Compaction Functions
+//------------------------------------------------------------------------------------
+
+void moveBird(Population *pop, int from, int to)
+{
+    pop->id[to] = pop->id[from];
+    pop->y[to] = pop->y[from];
+    pop->prevY[to] = pop->prevY[from];
+    pop->velocity[to] = pop->velocity[from];
+    pop->acceleration[to] = pop->acceleration[from];
+    pop->rotation[to] = pop->rotation[from];
+}
+
+void killBirds(Population *pop)
+{
+    // Walking down means the last live slot has already been checked when it moves into a hole
+    for (int i = pop->alive - 1; i >= 0; i--)
+    {
+        if (!pop->hit[i]) continue;
+
+        pop->deathStep[pop->id[i]] = pop->steps;
+        pop->alive--;
+        if (i != pop->alive) moveBird(pop, pop->alive, i);
+    }
+}
@@ -0,0 +1,53 @@
+#ifndef POPULATION_H
+#define POPULATION_H
+
+#include "sim.h"
+
+//------------------------------------------------------------------------------------
+// Bird Population
+//
+// Many birds flying one shared course: the map, pipes, scroll and speed live in one
+// SimState, while every bird has its own height, physics, score and alive flag. Live
+// birds stay packed at the front of the per-slot arrays, so a dead bird costs nothing
+// in later steps. Every bird starts in flight on the first step.
+//------------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------------
+// Types and Structures Definition
+//------------------------------------------------------------------------------------
+
+typedef struct Population
+{
+    SimState world;                     // Shared course, world.bird only supplies x and gravity
+
+    int capacity;
+    int count;                          // Birds in this run, 1 to capacity
+    int alive;                          // Live birds, packed into slots [0, alive)
+    int steps;                          // Steps since the last reset
+
+    // Per slot, moved when a bird dies so the live ones stay contiguous
+    int *id;                            // Bird index of each slot
+    SimReal *y;
+    SimReal *prevY;                     // y before the last step, collision and drawing use it
+    SimReal *velocity;
+    SimReal *acceleration;
+    SimReal *rotation;
+    unsigned char *hit;                 // Collision kernel output
+    unsigned char *scratch;
+
+    // Per bird index
+    int *score;                         // Pipes passed
+    int *deathStep;                     // Step the bird died on, -1 while alive
+
+} Population;
+
+//------------------------------------------------------------------------------------
+// Module Functions Declaration
+//------------------------------------------------------------------------------------
+
+Population *populationCreate(int capacity);                                 // Allocate room for capacity birds
+void populationReset(Population *pop, const SimConfig *config, int count);  // New course, count birds at the start
+int populationStep(Population *pop, const unsigned char *flap, float dt);   // flap[bird] != 0 flaps (NULL: nobody), returns SIM_EVENT_* bits
+void populationDestroy(Population *pop);
+
+#endif // POPULATION_H
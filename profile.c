@@ -0,0 +1,227 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <time.h>
+#include "profile.h"
+
+//------------------------------------------------------------------------------------
+// Defines Variables
+//------------------------------------------------------------------------------------
+
+#define PROFILE_RING_SIZE (1 << 16)     // Events per thread, a power of two; minutes of play at 60 FPS
+
+//------------------------------------------------------------------------------------
+// Types and Structures Definition
+//------------------------------------------------------------------------------------
+
+typedef struct ProfileEvent
+{
+    uint64_t start, end;                // profileNow() nanoseconds
+    ProfilePhase phase;
+
+} ProfileEvent;
+
+typedef struct ProfileRing
+{
+    ProfileEvent events[PROFILE_RING_SIZE];
+    atomic_uint_fast64_t head;          // Events ever written, stored after the event itself
+    char name[32];
+    int id;                             // Trace thread id
+    struct ProfileRing *next;           // Registry list, rings live until exit
+
+} ProfileRing;
+
+//------------------------------------------------------------------------------------
+// Global Variables Declaration
+//------------------------------------------------------------------------------------
+
+static _Atomic(ProfileRing *) rings;    // Every thread that recorded something
+static atomic_int ringCount;
+static _Thread_local ProfileRing *threadRing;
+
+static const char *phaseNames[PROFILE_PHASE_COUNT] =
+{
+#define PROFILE_PHASE_NAME(id, name) name,
+    PROFILE_PHASES(PROFILE_PHASE_NAME)
+#undef PROFILE_PHASE_NAME
+};
+
+//------------------------------------------------------------------------------------
+// Module Functions Declaration (local)
+//------------------------------------------------------------------------------------
+
+static ProfileRing *getRing(void);                                  // The calling thread's ring, registered on first use
+static bool readEvent(ProfileRing *ring, uint64_t index, ProfileEvent *event);  // False once the writer lapped it
+static int compareFloat(const void *a, const void *b);
+
+//------------------------------------------------------------------------------------
+// Recording Functions
+//------------------------------------------------------------------------------------
+
+uint64_t profileNow(void)
+{
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+
+    return (uint64_t) time.tv_sec * 1000000000u + (uint64_t) time.tv_nsec;
+}
+
+void profileRecord(ProfilePhase phase, uint64_t start, uint64_t end)
+{
+    ProfileRing *ring = getRing();
+    if (ring == NULL) return;
+
+    uint64_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    ProfileEvent *event = &ring->events[head & (PROFILE_RING_SIZE - 1)];
+
+    event->start = start;
+    event->end = end;
+    event->phase = phase;
+
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+}
+
+void profileNameThread(const char *name)
+{
+    ProfileRing *ring = getRing();
+    if (ring != NULL) snprintf(ring->name, sizeof(ring->name), "%s", name);
+}
+
+const char *profilePhaseName(ProfilePhase phase)
+{
+    return phaseNames[phase];
+}
+
+ProfileRing *getRing(void)
+{
+    if (threadRing != NULL) return threadRing;
+
+    ProfileRing *ring = calloc(1, sizeof(ProfileRing));
+    if (ring == NULL) return NULL;
+
+    ring->id = atomic_fetch_add(&ringCount, 1) + 1;
+    snprintf(ring->name, sizeof(ring->name), "thread %d", ring->id);
+
+    // Push onto the registry, readers only ever walk it from the head
+    ring->next = atomic_load(&rings);
+    while (!atomic_compare_exchange_weak(&rings, &ring->next, ring)) { }
+
+    threadRing = ring;
+
+    return ring;
+}
+
+bool readEvent(ProfileRing *ring, uint64_t index, ProfileEvent *event)
+{
+    *event = ring->events[index & (PROFILE_RING_SIZE - 1)];
+
+    // The slot is only rewritten for event index + PROFILE_RING_SIZE, which starts after
+    // head reaches index + PROFILE_RING_SIZE - 1
+    atomic_thread_fence(memory_order_acquire);
+
+    return atomic_load_explicit(&ring->head, memory_order_relaxed) < index + PROFILE_RING_SIZE;
+}
+
+//------------------------------------------------------------------------------------
+// Reporting Functions
+//------------------------------------------------------------------------------------
+
+void profileSummarize(ProfileSummary *summary)
+{
+    memset(summary, 0, sizeof(ProfileSummary));
+
+    ProfileRing *ring = getRing();
+    if (ring == NULL) return;
+
+    // Newest frames of this thread, walking back
+    uint64_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    uint64_t oldest = (head > PROFILE_RING_SIZE) ? head - PROFILE_RING_SIZE : 0;
+    uint64_t windowStart = UINT64_MAX;
+    float frames[PROFILE_HISTORY];
+
+    for (uint64_t i = head; i > oldest && summary->frames < PROFILE_HISTORY; i--)
+    {
+        ProfileEvent event;
+        if (!readEvent(ring, i - 1, &event)) break;
+        if (event.phase != PROFILE_FRAME) continue;
+
+        frames[summary->frames++] = (event.end - event.start) / 1e6f;
+        windowStart = event.start;
+    }
+
+    if (summary->frames == 0) return;
+
+    for (int i = 0; i < summary->frames; i++) summary->frameMs[i] = frames[summary->frames - 1 - i];
+
+    qsort(frames, summary->frames, sizeof(float), compareFloat);
+    summary->p50 = frames[(summary->frames - 1) / 2];
+    summary->p99 = frames[(summary->frames - 1) * 99 / 100];
+
+    // Phases of every thread that started inside the window
+    for (ProfileRing *other = atomic_load(&rings); other != NULL; other = other->next)
+    {
+        uint64_t otherHead = atomic_load_explicit(&other->head, memory_order_acquire);
+        uint64_t otherOldest = (otherHead > PROFILE_RING_SIZE) ? otherHead - PROFILE_RING_SIZE : 0;
+
+        for (uint64_t i = otherHead; i > otherOldest; i--)
+        {
+            ProfileEvent event;
+            if (!readEvent(other, i - 1, &event) || event.start < windowStart) break;
+
+            summary->phaseMs[event.phase] += (event.end - event.start) / 1e6f;
+        }
+    }
+
+    for (int i = 0; i < PROFILE_PHASE_COUNT; i++) summary->phaseMs[i] /= summary->frames;
+}
+
+bool profileWriteTrace(const char *path)
+{
+    FILE *file = fopen(path, "w");
+    if (file == NULL) return false;
+
+    // Timestamps relative to the earliest event still buffered
+    uint64_t origin = UINT64_MAX;
+    for (ProfileRing *ring = atomic_load(&rings); ring != NULL; ring = ring->next)
+    {
+        uint64_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+        uint64_t oldest = (head > PROFILE_RING_SIZE) ? head - PROFILE_RING_SIZE : 0;
+        ProfileEvent event;
+
+        if (head > oldest && readEvent(ring, oldest, &event) && event.start < origin) origin = event.start;
+    }
+
+    fprintf(file, "{\"traceEvents\":[\n");
+
+    bool first = true;
+    for (ProfileRing *ring = atomic_load(&rings); ring != NULL; ring = ring->next)
+    {
+        fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+                first ? "" : ",\n", ring->id, ring->name);
+        first = false;
+
+        uint64_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+        uint64_t oldest = (head > PROFILE_RING_SIZE) ? head - PROFILE_RING_SIZE : 0;
+
+        for (uint64_t i = oldest; i < head; i++)
+        {
+            ProfileEvent event;
+            if (!readEvent(ring, i, &event) || event.start < origin) continue;
+
+            fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%d}",
+                    phaseNames[event.phase], (event.start - origin) / 1e3, (event.end - event.start) / 1e3, ring->id);
+        }
+    }
+
+    fprintf(file, "\n]}\n");
+
+    return fclose(file) == 0;
+}
+
+int compareFloat(const void *a, const void *b)
+{
+    float x = *(const float *) a, y = *(const float *) b;
+
+    return (x > y) - (x < y);
+}
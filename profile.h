@@ -0,0 +1,80 @@
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+//------------------------------------------------------------------------------------
+// Frame Profiler
+//
+// Scoped phase timers: PROFILE_BEGIN(phase) and PROFILE_END(phase) around a block
+// record its start and end into a ring buffer owned by the calling thread. Only that
+// thread writes its ring, so recording takes no lock; readers copy events and drop any
+// the writer lapped meanwhile. The game draws a summary overlay and writes the
+// buffered events as Chrome trace JSON (chrome://tracing, Perfetto).
+//
+// Built only with PROFILE_ENABLED (CMake option FLAPPY_PROFILE). Otherwise the macros
+// expand to nothing and profile.c is not compiled.
+//------------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------------
+// Defines Variables
+//------------------------------------------------------------------------------------
+
+#define PROFILE_HISTORY 120             // Frames the summary covers
+
+#define PROFILE_PHASES(X)                       \
+    X(PROFILE_FRAME,   "frame")                 \
+    X(PROFILE_UPDATE,  "updateGame")            \
+    X(PROFILE_DRAW,    "drawGame")              \
+    X(PROFILE_PRESENT, "EndDrawing")            \
+    X(PROFILE_TEXT,    "text")                  \
+    X(PROFILE_AUDIO,   "audio")                 \
+    X(PROFILE_HISCORE, "hiScore")
+
+#define PROFILE_PHASE_ENUM(id, name) id,
+
+typedef enum ProfilePhase
+{
+    PROFILE_PHASES(PROFILE_PHASE_ENUM)
+    PROFILE_PHASE_COUNT
+
+} ProfilePhase;
+
+#undef PROFILE_PHASE_ENUM
+
+#if defined(PROFILE_ENABLED)
+    #define PROFILE_BEGIN(phase) uint64_t profileStart##phase = profileNow()
+    #define PROFILE_END(phase) profileRecord(phase, profileStart##phase, profileNow())
+    #define PROFILE_THREAD(name) profileNameThread(name)
+#else
+    #define PROFILE_BEGIN(phase) ((void) 0)
+    #define PROFILE_END(phase) ((void) 0)
+    #define PROFILE_THREAD(name) ((void) 0)
+#endif
+
+//------------------------------------------------------------------------------------
+// Types and Structures Definition
+//------------------------------------------------------------------------------------
+
+typedef struct ProfileSummary
+{
+    int frames;                         // Frames recorded, up to PROFILE_HISTORY
+    float frameMs[PROFILE_HISTORY];     // Oldest first
+    float p50, p99;                     // Frame time percentiles in ms
+    float phaseMs[PROFILE_PHASE_COUNT]; // Mean per frame over the same frames, all threads
+
+} ProfileSummary;
+
+//------------------------------------------------------------------------------------
+// Module Functions Declaration
+//------------------------------------------------------------------------------------
+
+uint64_t profileNow(void);                                              // Monotonic nanoseconds
+void profileRecord(ProfilePhase phase, uint64_t start, uint64_t end);   // Append to the calling thread's ring
+void profileNameThread(const char *name);                               // Thread name shown in the trace
+const char *profilePhaseName(ProfilePhase phase);
+void profileSummarize(ProfileSummary *summary);                         // Last frames recorded by the calling thread
+bool profileWriteTrace(const char *path);                               // Every thread's buffered events
+
+#endif // PROFILE_H
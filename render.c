@@ -0,0 +1,588 @@
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "workpool.h"
+#include "render.h"
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+#elif defined(__SSE2__)
+    #include <emmintrin.h>
+#endif
+
+//------------------------------------------------------------------------------------
+// Defines Variables
+//------------------------------------------------------------------------------------
+
+#define RENDER_SPRITE_SCALE 2.5f        // drawSprite() scale of the play field sprites
+#define RENDER_RESAMPLE 4               // Samples per axis when resampling a sprite
+#define RENDER_MAX_COMMANDS (4 + 2 * SIM_MAX_PIPES)
+#define RENDER_CLEAR 245                // RAYWHITE, under anything the sprites leave uncovered
+
+//------------------------------------------------------------------------------------
+// Types and Structures Definition
+//------------------------------------------------------------------------------------
+
+// A sprite resampled to the output scale, premultiplied
+typedef struct Layer
+{
+    int width, height;                  // Output pixels
+    unsigned char *values;              // Colour, width * height * pixelSize bytes
+    unsigned char *alpha;               // Alpha repeated for every colour byte, same layout as values
+    bool *opaqueRow;                    // Row needs no blending
+    int opaqueTop, opaqueBottom;        // Longest run of opaque rows, [top, bottom)
+
+} Layer;
+
+typedef struct DrawCommand
+{
+    AtlasSprite sprite;
+    int x, y;                           // Output pixels
+
+} DrawCommand;
+
+// What one frame draws, built by renderFrame before any tile runs
+typedef struct RenderScene
+{
+    DrawCommand commands[RENDER_MAX_COMMANDS];
+    int commandCount;
+    float birdX, birdY;                 // Screen point the frame's bottom-right corner is pinned to
+    float birdCos, birdSin;
+    int birdFrame;
+    int coverTop, coverBottom;          // Output rows an opaque layer fills edge to edge, not cleared
+    unsigned char *pixels;
+
+} RenderScene;
+
+typedef struct RenderTile
+{
+    const Renderer *renderer;
+    const RenderScene *scene;
+    int top, bottom;                    // Output rows [top, bottom)
+
+} RenderTile;
+
+struct Renderer
+{
+    RenderConfig config;
+    int pixelSize;
+    float scaleX, scaleY;               // Output pixels per screen pixel
+
+    Layer layers[ATLAS_COUNT];          // Play field sprites only
+
+    unsigned char *birdSheet;           // Premultiplied RGBA copy of the bird frames
+    int birdSheetWidth, birdHeight;
+    float birdFrameWidth;
+    int birdSamples;                    // Per axis, more when the output is small
+
+    unsigned char *clearRow;            // One output row of the clear colour
+
+    WorkPool *pool;
+    int tileCount;
+    int tileHeight;
+    RenderTile *tiles;                  // Pool jobs, only used when there is a pool
+};
+
+//------------------------------------------------------------------------------------
+// Module Functions Declaration (local)
+//------------------------------------------------------------------------------------
+
+static bool buildLayer(Renderer *renderer, Layer *layer, const PackedImage *atlas, AtlasRect rect);  // Resample one sprite
+static bool buildBirdSheet(Renderer *renderer, const PackedImage *atlas, AtlasRect rect);
+static void renderTile(void *arg);                                  // Draw every command clipped to one tile, a pool job
+static void drawLayer(const Renderer *renderer, const RenderScene *scene, const DrawCommand *command, int top, int bottom);
+static void drawBird(const Renderer *renderer, const RenderScene *scene, int top, int bottom);
+static void blendBytes(unsigned char *dst, const unsigned char *src, const unsigned char *alpha, int count);
+static inline unsigned char luma(int r, int g, int b);             // Rec. 601 weights
+
+//------------------------------------------------------------------------------------
+// Renderer Functions
+//------------------------------------------------------------------------------------
+
+RenderConfig renderDefaultConfig(void)
+{
+    RenderConfig config;
+
+    config.width = 84;
+    config.height = 84;
+    config.format = RENDER_GRAY;
+    config.threads = 0;
+    config.tileHeight = 64;
+
+    return config;
+}
+
+Renderer *renderCreate(const RenderConfig *config, const PackedImage *atlas, const AtlasRect *rects)
+{
+    static const AtlasSprite sprites[] = { ATLAS_BACKGROUND, ATLAS_FOREGROUND, ATLAS_TOP_PIPE, ATLAS_BOTTOM_PIPE };
+
+    if (config->width < 1 || config->height < 1 || atlas->pixels == NULL) return NULL;
+
+    Renderer *renderer = calloc(1, sizeof(Renderer));
+    if (renderer == NULL) return NULL;
+
+    renderer->config = *config;
+    renderer->pixelSize = (config->format == RENDER_RGBA) ? 4 : 1;
+    renderer->scaleX = (float) config->width / RENDER_SCREEN_WIDTH;
+    renderer->scaleY = (float) config->height / RENDER_SCREEN_HEIGHT;
+
+    bool ok = true;
+    for (size_t i = 0; i < sizeof(sprites) / sizeof(sprites[0]); i++)
+    {
+        ok = ok && buildLayer(renderer, &renderer->layers[sprites[i]], atlas, rects[sprites[i]]);
+    }
+    ok = ok && buildBirdSheet(renderer, atlas, rects[ATLAS_BIRD]);
+
+    renderer->clearRow = malloc((size_t) config->width * renderer->pixelSize);
+    ok = ok && (renderer->clearRow != NULL);
+    for (int i = 0; ok && i < config->width * renderer->pixelSize; i++)
+    {
+        renderer->clearRow[i] = (renderer->pixelSize == 4 && i % 4 == 3) ? 255 : RENDER_CLEAR;
+    }
+
+    // Tiles, run through the pool only when there is more than one thread to run them
+    renderer->tileHeight = (config->tileHeight > 0) ? config->tileHeight : config->height;
+    renderer->tileCount = (config->height + renderer->tileHeight - 1) / renderer->tileHeight;
+
+    if (ok && config->threads > 1)
+    {
+        renderer->pool = workPoolCreate(config->threads);
+        renderer->tiles = calloc(renderer->tileCount, sizeof(RenderTile));
+        ok = (renderer->pool != NULL) && (renderer->tiles != NULL);
+
+        for (int i = 0; ok && i < renderer->tileCount; i++)
+        {
+            renderer->tiles[i].renderer = renderer;
+            renderer->tiles[i].top = i * renderer->tileHeight;
+            renderer->tiles[i].bottom = (i + 1 < renderer->tileCount) ? (i + 1) * renderer->tileHeight : config->height;
+        }
+    }
+
+    if (!ok)
+    {
+        renderDestroy(renderer);
+        return NULL;
+    }
+
+    return renderer;
+}
+
+void renderFrame(Renderer *renderer, const SimState *state, unsigned char *pixels)
+{
+    const float sx = renderer->scaleX, sy = renderer->scaleY;
+    const SimConfig *config = &state->config;
+    RenderScene scene;
+    int count = 0;
+
+    // Scene, in drawGame() order: background, pipes, foreground, bird
+    //------------------------------------------
+    float backX = simToFloat(state->map.scrollingBack), backY = simToFloat(state->map.backgroundY);
+    float foreX = simToFloat(state->map.scrollingFore), foreY = simToFloat(state->map.foregroundY);
+
+    // The second copy sits at twice the unscaled width, as drawGame() places it
+    scene.commands[count++] = (DrawCommand) { ATLAS_BACKGROUND, (int) floorf(backX * sx + 0.5f), (int) floorf(backY * sy + 0.5f) };
+    scene.commands[count++] = (DrawCommand) { ATLAS_BACKGROUND, (int) floorf((config->backgroundWidth * 2 + backX) * sx + 0.5f), (int) floorf(backY * sy + 0.5f) };
+
+    if (state->gameRun || state->gameOver)
+    {
+        for (int n = 0; n < config->pipeCount; n++)
+        {
+            int i = (state->pipeHead + n) % config->pipeCount;
+            float x = simToFloat(state->pipes.x[i] - state->scroll);
+
+            if (x > RENDER_SCREEN_WIDTH) break;
+
+            int left = (int) floorf(x * sx + 0.5f);
+            scene.commands[count++] = (DrawCommand) { ATLAS_TOP_PIPE, left, (int) floorf((simToFloat(state->pipes.gapTop[i]) - config->pipeHeight) * sy + 0.5f) };
+            scene.commands[count++] = (DrawCommand) { ATLAS_BOTTOM_PIPE, left, (int) floorf(simToFloat(state->pipes.gapBottom[i]) * sy + 0.5f) };
+        }
+    }
+
+    scene.commands[count++] = (DrawCommand) { ATLAS_FOREGROUND, (int) floorf(foreX * sx + 0.5f), (int) floorf(foreY * sy + 0.5f) };
+    scene.commands[count++] = (DrawCommand) { ATLAS_FOREGROUND, (int) floorf((config->foregroundWidth * 2 + foreX) * sx + 0.5f), (int) floorf(foreY * sy + 0.5f) };
+    scene.commandCount = count;
+
+    // Rows some opaque layer spans edge to edge need no clear, usually the whole background
+    scene.coverTop = scene.coverBottom = 0;
+    for (int i = 0; i < count; i++)
+    {
+        const DrawCommand *command = &scene.commands[i];
+        const Layer *layer = &renderer->layers[command->sprite];
+
+        if (command->x > 0 || command->x + layer->width < renderer->config.width) continue;
+        if (layer->opaqueBottom - layer->opaqueTop <= scene.coverBottom - scene.coverTop) continue;
+
+        scene.coverTop = command->y + layer->opaqueTop;
+        scene.coverBottom = command->y + layer->opaqueBottom;
+    }
+
+    float birdX = simToFloat(state->bird.x);
+    float angle = simToFloat(state->bird.rotation) * (3.14159265f / 180.0f);
+
+    scene.birdX = birdX + birdX / 3;
+    scene.birdY = simToFloat(state->bird.y);
+    scene.birdCos = cosf(angle);
+    scene.birdSin = sinf(angle);
+    scene.birdFrame = state->currentFrame;
+    scene.pixels = pixels;
+
+    // Tiles
+    //------------------------------------------
+    if (renderer->pool == NULL)
+    {
+        for (int top = 0; top < renderer->config.height; top += renderer->tileHeight)
+        {
+            int bottom = (top + renderer->tileHeight < renderer->config.height) ? top + renderer->tileHeight : renderer->config.height;
+            RenderTile tile = { renderer, &scene, top, bottom };
+
+            renderTile(&tile);
+        }
+    }
+    else
+    {
+        for (int i = 0; i < renderer->tileCount; i++)
+        {
+            renderer->tiles[i].scene = &scene;
+            workPoolSubmit(renderer->pool, renderTile, &renderer->tiles[i]);
+        }
+        workPoolWait(renderer->pool);
+    }
+}
+
+int renderPixelSize(const Renderer *renderer)
+{
+    return renderer->pixelSize;
+}
+
+void renderDestroy(Renderer *renderer)
+{
+    if (renderer == NULL) return;
+
+    workPoolDestroy(renderer->pool);
+
+    for (int i = 0; i < ATLAS_COUNT; i++)
+    {
+        free(renderer->layers[i].values);
+        free(renderer->layers[i].alpha);
+        free(renderer->layers[i].opaqueRow);
+    }
+
+    free(renderer->birdSheet);
+    free(renderer->clearRow);
+    free(renderer->tiles);
+    free(renderer);
+}
+
+//------------------------------------------------------------------------------------
+// Sprite Preparation Functions
+//------------------------------------------------------------------------------------
+
+bool buildLayer(Renderer *renderer, Layer *layer, const PackedImage *atlas, AtlasRect rect)
+{
+    const int pixelSize = renderer->pixelSize;
+    const float scaleX = RENDER_SPRITE_SCALE * renderer->scaleX;    // Output pixels per atlas texel
+    const float scaleY = RENDER_SPRITE_SCALE * renderer->scaleY;
+    const int samples = RENDER_RESAMPLE * RENDER_RESAMPLE;
+
+    int srcWidth = (int) rect.width, srcHeight = (int) rect.height;
+    if (srcWidth < 1 || srcHeight < 1) return true;                 // Missing from the pack, drawn as nothing
+
+    layer->width = (int) floorf(srcWidth * scaleX + 0.5f);
+    layer->height = (int) floorf(srcHeight * scaleY + 0.5f);
+    if (layer->width < 1) layer->width = 1;
+    if (layer->height < 1) layer->height = 1;
+
+    size_t size = (size_t) layer->width * layer->height * pixelSize;
+    layer->values = malloc(size);
+    layer->alpha = malloc(size);
+    layer->opaqueRow = malloc(layer->height * sizeof(bool));
+    if (layer->values == NULL || layer->alpha == NULL || layer->opaqueRow == NULL) return false;
+
+    // Box filter: average a grid of point samples over each output pixel's footprint
+    for (int y = 0; y < layer->height; y++)
+    {
+        bool opaque = true;
+
+        for (int x = 0; x < layer->width; x++)
+        {
+            int r = 0, g = 0, b = 0, a = 0;
+
+            for (int j = 0; j < RENDER_RESAMPLE; j++)
+            {
+                int v = (int) ((y + (j + 0.5f) / RENDER_RESAMPLE) / scaleY);
+                if (v >= srcHeight) v = srcHeight - 1;
+
+                for (int i = 0; i < RENDER_RESAMPLE; i++)
+                {
+                    int u = (int) ((x + (i + 0.5f) / RENDER_RESAMPLE) / scaleX);
+                    if (u >= srcWidth) u = srcWidth - 1;
+
+                    const unsigned char *texel = atlas->pixels + (((size_t) rect.y + v) * atlas->width + (size_t) rect.x + u) * 4;
+                    r += texel[0] * texel[3];
+                    g += texel[1] * texel[3];
+                    b += texel[2] * texel[3];
+                    a += texel[3];
+                }
+            }
+
+            // Premultiplied averages
+            r = (r / 255 + samples / 2) / samples;
+            g = (g / 255 + samples / 2) / samples;
+            b = (b / 255 + samples / 2) / samples;
+            a = (a + samples / 2) / samples;
+            if (a < 255) opaque = false;
+
+            size_t offset = ((size_t) y * layer->width + x) * pixelSize;
+            if (pixelSize == 4)
+            {
+                layer->values[offset + 0] = (unsigned char) r;
+                layer->values[offset + 1] = (unsigned char) g;
+                layer->values[offset + 2] = (unsigned char) b;
+                layer->values[offset + 3] = (unsigned char) a;
+                memset(layer->alpha + offset, a, 4);
+            }
+            else
+            {
+                layer->values[offset] = luma(r, g, b);
+                layer->alpha[offset] = (unsigned char) a;
+            }
+        }
+
+        layer->opaqueRow[y] = opaque;
+    }
+
+    for (int y = 0, run = 0; y < layer->height; y++)
+    {
+        run = layer->opaqueRow[y] ? run + 1 : 0;
+        if (run > layer->opaqueBottom - layer->opaqueTop)
+        {
+            layer->opaqueTop = y + 1 - run;
+            layer->opaqueBottom = y + 1;
+        }
+    }
+
+    return true;
+}
+
+bool buildBirdSheet(Renderer *renderer, const PackedImage *atlas, AtlasRect rect)
+{
+    renderer->birdSheetWidth = (int) rect.width;
+    renderer->birdHeight = (int) rect.height;
+    renderer->birdFrameWidth = rect.width / 3;
+
+    // Enough samples per output pixel to see every texel of the frame at small sizes
+    float scale = (renderer->scaleX < renderer->scaleY) ? renderer->scaleX : renderer->scaleY;
+    renderer->birdSamples = (int) ceilf(1.0f / scale);
+    if (renderer->birdSamples < 1) renderer->birdSamples = 1;
+    if (renderer->birdSamples > RENDER_RESAMPLE) renderer->birdSamples = RENDER_RESAMPLE;
+
+    if (renderer->birdSheetWidth < 1 || renderer->birdHeight < 1) return true;
+
+    renderer->birdSheet = malloc((size_t) renderer->birdSheetWidth * renderer->birdHeight * 4);
+    if (renderer->birdSheet == NULL) return false;
+
+    for (int y = 0; y < renderer->birdHeight; y++)
+    {
+        for (int x = 0; x < renderer->birdSheetWidth; x++)
+        {
+            const unsigned char *texel = atlas->pixels + (((size_t) rect.y + y) * atlas->width + (size_t) rect.x + x) * 4;
+            unsigned char *out = renderer->birdSheet + ((size_t) y * renderer->birdSheetWidth + x) * 4;
+
+            for (int c = 0; c < 3; c++) out[c] = (unsigned char) ((texel[c] * texel[3] + 127) / 255);
+            out[3] = texel[3];
+        }
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------
+// Tile Functions
+//------------------------------------------------------------------------------------
+
+void renderTile(void *arg)
+{
+    const RenderTile *tile = arg;
+    const Renderer *renderer = tile->renderer;
+    const RenderScene *scene = tile->scene;
+    const int rowBytes = renderer->config.width * renderer->pixelSize;
+
+    // Clear what the scene doesn't cover, then every command clipped to the tile's rows
+    for (int y = tile->top; y < tile->bottom; y++)
+    {
+        if (y >= scene->coverTop && y < scene->coverBottom) y = scene->coverBottom;
+        if (y < tile->bottom) memcpy(scene->pixels + (size_t) y * rowBytes, renderer->clearRow, rowBytes);
+    }
+
+    for (int i = 0; i < scene->commandCount; i++) drawLayer(renderer, scene, &scene->commands[i], tile->top, tile->bottom);
+    drawBird(renderer, scene, tile->top, tile->bottom);
+}
+
+void drawLayer(const Renderer *renderer, const RenderScene *scene, const DrawCommand *command, int top, int bottom)
+{
+    const Layer *layer = &renderer->layers[command->sprite];
+    const int pixelSize = renderer->pixelSize;
+
+    if (layer->values == NULL) return;
+
+    int rowStart = (command->y > top) ? command->y : top;
+    int rowEnd = (command->y + layer->height < bottom) ? command->y + layer->height : bottom;
+    int colStart = (command->x > 0) ? command->x : 0;
+    int colEnd = (command->x + layer->width < renderer->config.width) ? command->x + layer->width : renderer->config.width;
+
+    if (rowStart >= rowEnd || colStart >= colEnd) return;
+
+    int count = (colEnd - colStart) * pixelSize;
+
+    for (int y = rowStart; y < rowEnd; y++)
+    {
+        int row = y - command->y;
+        size_t src = ((size_t) row * layer->width + (colStart - command->x)) * pixelSize;
+        unsigned char *dst = scene->pixels + ((size_t) y * renderer->config.width + colStart) * pixelSize;
+
+        if (layer->opaqueRow[row]) memcpy(dst, layer->values + src, count);
+        else blendBytes(dst, layer->values + src, layer->alpha + src, count);
+    }
+}
+
+void drawBird(const Renderer *renderer, const RenderScene *scene, int top, int bottom)
+{
+    const float sx = renderer->scaleX, sy = renderer->scaleY;
+    const float c = scene->birdCos, s = scene->birdSin;
+    const float frameWidth = renderer->birdFrameWidth, height = (float) renderer->birdHeight;
+    const int samples = renderer->birdSamples;
+    const int frameLeft = (int) (scene->birdFrame * frameWidth);
+
+    if (renderer->birdSheet == NULL) return;
+
+    // Screen bounding box of the frame rotated about its bottom-right corner (its drawing origin)
+    float minX = scene->birdX, maxX = scene->birdX, minY = scene->birdY, maxY = scene->birdY;
+    const float cornerX[3] = { -frameWidth, -frameWidth, 0 }, cornerY[3] = { -height, 0, -height };
+
+    for (int i = 0; i < 3; i++)
+    {
+        float x = scene->birdX + cornerX[i] * c - cornerY[i] * s;
+        float y = scene->birdY + cornerX[i] * s + cornerY[i] * c;
+
+        if (x < minX) minX = x;
+        if (x > maxX) maxX = x;
+        if (y < minY) minY = y;
+        if (y > maxY) maxY = y;
+    }
+
+    int rowStart = (int) floorf(minY * sy), rowEnd = (int) ceilf(maxY * sy);
+    int colStart = (int) floorf(minX * sx), colEnd = (int) ceilf(maxX * sx);
+
+    if (rowStart < top) rowStart = top;
+    if (rowEnd > bottom) rowEnd = bottom;
+    if (colStart < 0) colStart = 0;
+    if (colEnd > renderer->config.width) colEnd = renderer->config.width;
+
+    // Inverse mapping: each sample point back into the frame, premultiplied sums averaged
+    for (int y = rowStart; y < rowEnd; y++)
+    {
+        for (int x = colStart; x < colEnd; x++)
+        {
+            int sum[4] = { 0 };
+
+            for (int j = 0; j < samples; j++)
+            {
+                float dy = (y + (j + 0.5f) / samples) / sy - scene->birdY;
+
+                for (int i = 0; i < samples; i++)
+                {
+                    float dx = (x + (i + 0.5f) / samples) / sx - scene->birdX;
+                    float u = frameWidth + c * dx + s * dy;
+                    float v = height - s * dx + c * dy;
+
+                    if (u < 0 || v < 0 || u >= frameWidth || v >= height) continue;
+
+                    const unsigned char *texel = renderer->birdSheet + ((size_t) v * renderer->birdSheetWidth + frameLeft + (int) u) * 4;
+                    for (int k = 0; k < 4; k++) sum[k] += texel[k];
+                }
+            }
+
+            int area = samples * samples;
+            int alpha = (sum[3] + area / 2) / area;
+            if (alpha == 0) continue;
+
+            unsigned char *dst = scene->pixels + ((size_t) y * renderer->config.width + x) * renderer->pixelSize;
+            unsigned char color[4];
+            unsigned char coverage[4];
+
+            for (int k = 0; k < 4; k++)
+            {
+                color[k] = (unsigned char) ((sum[k] + area / 2) / area);
+                coverage[k] = (unsigned char) alpha;
+            }
+
+            if (renderer->pixelSize == 1) color[0] = luma(color[0], color[1], color[2]);
+
+            blendBytes(dst, color, coverage, renderer->pixelSize);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------------
+// Blending Functions
+//
+// Premultiplied "over": dst = src + dst * (255 - alpha) / 255 for every byte, with
+// the division done as (x + 128 + ((x + 128) >> 8)) >> 8, exact for 8-bit products.
+//------------------------------------------------------------------------------------
+
+void blendBytes(unsigned char *dst, const unsigned char *src, const unsigned char *alpha, int count)
+{
+    int i = 0;
+
+#if defined(__AVX2__)
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i half = _mm256_set1_epi16(128);
+    const __m256i full = _mm256_set1_epi8((char) 0xFF);
+
+    for (; i + 32 <= count; i += 32)
+    {
+        __m256i d = _mm256_loadu_si256((const __m256i *) (dst + i));
+        __m256i inverse = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *) (alpha + i)), full);
+
+        __m256i low = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(d, zero), _mm256_unpacklo_epi8(inverse, zero)), half);
+        __m256i high = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(d, zero), _mm256_unpackhi_epi8(inverse, zero)), half);
+        low = _mm256_srli_epi16(_mm256_add_epi16(low, _mm256_srli_epi16(low, 8)), 8);
+        high = _mm256_srli_epi16(_mm256_add_epi16(high, _mm256_srli_epi16(high, 8)), 8);
+
+        // Unpack and pack both work per 128-bit lane, so the byte order comes back as it was
+        __m256i scaled = _mm256_packus_epi16(low, high);
+        _mm256_storeu_si256((__m256i *) (dst + i), _mm256_adds_epu8(scaled, _mm256_loadu_si256((const __m256i *) (src + i))));
+    }
+#elif defined(__SSE2__)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i half = _mm_set1_epi16(128);
+    const __m128i full = _mm_set1_epi8((char) 0xFF);
+
+    for (; i + 16 <= count; i += 16)
+    {
+        __m128i d = _mm_loadu_si128((const __m128i *) (dst + i));
+        __m128i inverse = _mm_xor_si128(_mm_loadu_si128((const __m128i *) (alpha + i)), full);
+
+        __m128i low = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), _mm_unpacklo_epi8(inverse, zero)), half);
+        __m128i high = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), _mm_unpackhi_epi8(inverse, zero)), half);
+        low = _mm_srli_epi16(_mm_add_epi16(low, _mm_srli_epi16(low, 8)), 8);
+        high = _mm_srli_epi16(_mm_add_epi16(high, _mm_srli_epi16(high, 8)), 8);
+
+        __m128i scaled = _mm_packus_epi16(low, high);
+        _mm_storeu_si128((__m128i *) (dst + i), _mm_adds_epu8(scaled, _mm_loadu_si128((const __m128i *) (src + i))));
+    }
+#endif
+
+    for (; i < count; i++)
+    {
+        int x = dst[i] * (255 - alpha[i]) + 128;
+        int value = src[i] + ((x + (x >> 8)) >> 8);
+
+        dst[i] = (unsigned char) ((value > 255) ? 255 : value);
+    }
+}
+
+unsigned char luma(int r, int g, int b)
+{
+    return (unsigned char) ((77 * r + 150 * g + 29 * b + 128) >> 8);
+}
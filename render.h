@@ -0,0 +1,61 @@
+#ifndef RENDER_H
+#define RENDER_H
+
+#include "sim.h"
+#include "assetpack.h"
+
+//------------------------------------------------------------------------------------
+// Software Renderer
+//
+// Draws the play field of a SimState into a caller-supplied buffer without a GPU:
+// scrolling background and foreground, pipes and the rotated bird frame, the same
+// placement drawGame() uses, minus text and menu sprites. The 490x735 screen is
+// scaled to the output size, e.g. 84x84 grayscale for pixel observations.
+//
+// Sprites are resampled to the output scale once, at renderCreate, so a frame is
+// row copies for opaque rows and SIMD alpha blends for the rest. The frame is
+// split into horizontal tiles that run as worker pool jobs when threads > 1.
+// Without threads a renderer is read-only while drawing, so several threads can
+// draw frames through the same one at once.
+//------------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------------
+// Defines Variables
+//------------------------------------------------------------------------------------
+
+#define RENDER_SCREEN_WIDTH 490         // Game window the scene is laid out in
+#define RENDER_SCREEN_HEIGHT 735
+
+//------------------------------------------------------------------------------------
+// Types and Structures Definition
+//------------------------------------------------------------------------------------
+
+typedef enum RenderFormat
+{
+    RENDER_RGBA = 0,                    // 4 bytes per pixel
+    RENDER_GRAY,                        // 1 byte per pixel, Rec. 601 luma
+
+} RenderFormat;
+
+typedef struct RenderConfig
+{
+    int width, height;                  // Output size in pixels
+    RenderFormat format;
+    int threads;                        // Tile workers, 0 or 1 renders on the calling thread
+    int tileHeight;                     // Rows per tile job
+
+} RenderConfig;
+
+typedef struct Renderer Renderer;
+
+//------------------------------------------------------------------------------------
+// Module Functions Declaration
+//------------------------------------------------------------------------------------
+
+RenderConfig renderDefaultConfig(void);                                     // 84x84 grayscale on the calling thread
+Renderer *renderCreate(const RenderConfig *config, const PackedImage *atlas, const AtlasRect *rects);  // rects: ATLAS_COUNT source rectangles
+void renderFrame(Renderer *renderer, const SimState *state, unsigned char *pixels);  // width * height * bytes per pixel, rows packed
+int renderPixelSize(const Renderer *renderer);                              // Bytes per output pixel
+void renderDestroy(Renderer *renderer);
+
+#endif // RENDER_H
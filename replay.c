@@ -0,0 +1,311 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "replay.h"
+
+//------------------------------------------------------------------------------------
+// Defines Variables
+//------------------------------------------------------------------------------------
+
+#define REPLAY_VERSION 1
+#if defined(SIM_FIXED_POINT)
+    #define REPLAY_FORMAT (REPLAY_VERSION | 0x80)   // Fixed-point steps differ from float ones, keep the two apart
+#else
+    #define REPLAY_FORMAT REPLAY_VERSION
+#endif
+#define REPLAY_MAX_RUN SIM_TICK_RATE    // Longest run between two hashes
+#define REPLAY_INPUT_BITS 2             // SIM_INPUT_JUMP | SIM_INPUT_RESTART
+#define REPLAY_INPUT_MASK ((1u << REPLAY_INPUT_BITS) - 1)
+
+//------------------------------------------------------------------------------------
+// Types and Structures Definition
+//------------------------------------------------------------------------------------
+
+struct Replay
+{
+    SimConfig config;
+
+    unsigned char *runs;                // Encoded runs, without the header
+    size_t size;
+    size_t capacity;
+
+    unsigned int runInput;              // Run being recorded or played
+    int runLength;                      // Recording: steps so far, playback: steps left
+    uint16_t runHash;                   // Recording: hash after the latest step, playback: expected hash
+
+    size_t cursor;                      // Playback read position in runs
+    int tick;
+    ReplayStatus status;
+};
+
+//------------------------------------------------------------------------------------
+// Module Functions Declaration (local)
+//------------------------------------------------------------------------------------
+
+static bool putByte(Replay *replay, unsigned char byte);
+static bool putVarint(Replay *replay, uint64_t value);          // LEB128, 7 bits per byte
+static bool getVarint(const unsigned char *data, size_t size, size_t *cursor, uint64_t *value);
+static void flushRun(Replay *replay);                           // Encode the run being recorded
+static uint16_t foldHash(uint32_t hash);
+
+//------------------------------------------------------------------------------------
+// Recording Functions
+//------------------------------------------------------------------------------------
+
+Replay *replayCreate(const SimConfig *config)
+{
+    Replay *replay = calloc(1, sizeof(Replay));
+    if (replay == NULL) return NULL;
+
+    replay->config = *config;
+
+    return replay;
+}
+
+void replayRecord(Replay *replay, unsigned int input, const SimState *state)
+{
+    if (replay == NULL) return;
+
+    input &= REPLAY_INPUT_MASK;
+    if (replay->runLength > 0 && (input != replay->runInput || replay->runLength == REPLAY_MAX_RUN)) flushRun(replay);
+
+    replay->runInput = input;
+    replay->runLength++;
+    replay->runHash = foldHash(simHash(state));
+    replay->tick++;
+}
+
+bool replaySave(Replay *replay, const char *path)
+{
+    if (replay == NULL) return false;
+
+    flushRun(replay);
+
+    FILE *outFile = fopen(path, "wb");
+    if (outFile == NULL) return false;
+
+    // Header: magic, version, the config floats as little-endian bits, then varints
+    //------------------------------------------
+    const SimConfig *config = &replay->config;
+    const float sizes[] =
+    {
+        config->backgroundWidth, config->foregroundWidth, config->foregroundHeight,
+        config->birdFrameWidth, config->birdHeight, config->pipeWidth, config->pipeHeight,
+        config->pipeDistance,
+    };
+    Replay header = { 0 };
+
+    for (int i = 0; i < 4; i++) putByte(&header, "FLRP"[i]);
+    putByte(&header, REPLAY_FORMAT);
+
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+    {
+        uint32_t bits;
+        memcpy(&bits, &sizes[i], sizeof(bits));
+        for (int b = 0; b < 4; b++) putByte(&header, (bits >> (b * 8)) & 0xFF);
+    }
+
+    putVarint(&header, (uint64_t) config->pipeCount);
+    putVarint(&header, config->seed);
+    putVarint(&header, config->stream);
+
+    bool ok = (header.runs != NULL) && (fwrite(header.runs, 1, header.size, outFile) == header.size);
+    if (ok && replay->size > 0) ok = (fwrite(replay->runs, 1, replay->size, outFile) == replay->size);
+    if (ok) ok = (fputc(0, outFile) != EOF);        // Terminator, a zero-length run
+
+    if (fclose(outFile) != 0) ok = false;
+    free(header.runs);
+
+    return ok;
+}
+
+//------------------------------------------------------------------------------------
+// Playback Functions
+//------------------------------------------------------------------------------------
+
+Replay *replayLoad(const char *path)
+{
+    FILE *inFile = fopen(path, "rb");
+    if (inFile == NULL) return NULL;
+
+    fseek(inFile, 0, SEEK_END);
+    long fileSize = ftell(inFile);
+    fseek(inFile, 0, SEEK_SET);
+
+    unsigned char *data = (fileSize > 0) ? malloc(fileSize) : NULL;
+    bool ok = (data != NULL) && (fread(data, 1, fileSize, inFile) == (size_t) fileSize);
+    fclose(inFile);
+
+    Replay *replay = ok ? calloc(1, sizeof(Replay)) : NULL;
+    size_t cursor = 5;
+    float sizes[8];
+    uint64_t pipeCount = 0;
+
+    ok = (replay != NULL) && (fileSize >= (long) (5 + sizeof(sizes))) && (memcmp(data, "FLRP", 4) == 0) && (data[4] == REPLAY_FORMAT);
+
+    if (ok)
+    {
+        for (int i = 0; i < 8; i++)
+        {
+            uint32_t bits = 0;
+            for (int b = 0; b < 4; b++) bits |= (uint32_t) data[cursor++] << (b * 8);
+            memcpy(&sizes[i], &bits, sizeof(bits));
+        }
+
+        SimConfig *config = &replay->config;
+        config->backgroundWidth = sizes[0];
+        config->foregroundWidth = sizes[1];
+        config->foregroundHeight = sizes[2];
+        config->birdFrameWidth = sizes[3];
+        config->birdHeight = sizes[4];
+        config->pipeWidth = sizes[5];
+        config->pipeHeight = sizes[6];
+        config->pipeDistance = sizes[7];
+
+        ok = getVarint(data, fileSize, &cursor, &pipeCount) &&
+             getVarint(data, fileSize, &cursor, &config->seed) &&
+             getVarint(data, fileSize, &cursor, &config->stream);
+        config->pipeCount = (int) pipeCount;
+    }
+
+    if (!ok)
+    {
+        free(data);
+        free(replay);
+        return NULL;
+    }
+
+    // Keep the runs only, the header has been decoded
+    replay->size = fileSize - cursor;
+    replay->runs = malloc(replay->size);
+    if (replay->runs != NULL) memcpy(replay->runs, data + cursor, replay->size);
+    replay->capacity = replay->size;
+    free(data);
+
+    if (replay->runs == NULL)
+    {
+        free(replay);
+        return NULL;
+    }
+
+    return replay;
+}
+
+const SimConfig *replayConfig(const Replay *replay)
+{
+    return &replay->config;
+}
+
+ReplayStatus replayStep(Replay *replay, SimState *state, int *events)
+{
+    if (events != NULL) *events = 0;
+    if (replay->status != REPLAY_PLAYING) return replay->status;
+
+    // Start the next run
+    if (replay->runLength == 0)
+    {
+        uint64_t value = 0;
+
+        if (!getVarint(replay->runs, replay->size, &replay->cursor, &value) || (value >> REPLAY_INPUT_BITS) == 0 ||
+            replay->cursor + 2 > replay->size)
+        {
+            replay->status = REPLAY_ENDED;
+            return replay->status;
+        }
+
+        replay->runInput = (unsigned int) (value & REPLAY_INPUT_MASK);
+        replay->runLength = (int) (value >> REPLAY_INPUT_BITS);
+        replay->runHash = replay->runs[replay->cursor] | (replay->runs[replay->cursor + 1] << 8);
+        replay->cursor += 2;
+    }
+
+    int stepEvents = simStep(state, replay->runInput, SIM_DT);
+    if (events != NULL) *events = stepEvents;
+
+    replay->tick++;
+    replay->runLength--;
+
+    if (replay->runLength == 0 && foldHash(simHash(state)) != replay->runHash) replay->status = REPLAY_DESYNC;
+
+    return replay->status;
+}
+
+int replayTick(const Replay *replay)
+{
+    return replay->tick;
+}
+
+void replayDestroy(Replay *replay)
+{
+    if (replay == NULL) return;
+
+    free(replay->runs);
+    free(replay);
+}
+
+//------------------------------------------------------------------------------------
+// Encoding Functions
+//------------------------------------------------------------------------------------
+
+bool putByte(Replay *replay, unsigned char byte)
+{
+    if (replay->size == replay->capacity)
+    {
+        size_t capacity = (replay->capacity > 0) ? replay->capacity * 2 : 1024;
+        unsigned char *runs = realloc(replay->runs, capacity);
+        if (runs == NULL) return false;
+
+        replay->runs = runs;
+        replay->capacity = capacity;
+    }
+
+    replay->runs[replay->size++] = byte;
+
+    return true;
+}
+
+bool putVarint(Replay *replay, uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        if (!putByte(replay, (value & 0x7F) | 0x80)) return false;
+        value >>= 7;
+    }
+
+    return putByte(replay, (unsigned char) value);
+}
+
+bool getVarint(const unsigned char *data, size_t size, size_t *cursor, uint64_t *value)
+{
+    uint64_t result = 0;
+
+    for (int shift = 0; shift < 64 && *cursor < size; shift += 7)
+    {
+        unsigned char byte = data[(*cursor)++];
+
+        result |= (uint64_t) (byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+        {
+            *value = result;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void flushRun(Replay *replay)
+{
+    if (replay->runLength == 0) return;
+
+    putVarint(replay, ((uint64_t) replay->runLength << REPLAY_INPUT_BITS) | replay->runInput);
+    putByte(replay, replay->runHash & 0xFF);
+    putByte(replay, replay->runHash >> 8);
+
+    replay->runLength = 0;
+}
+
+uint16_t foldHash(uint32_t hash)
+{
+    return (uint16_t) (hash ^ (hash >> 16));
+}
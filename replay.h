@@ -0,0 +1,50 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <stdbool.h>
+#include "sim.h"
+
+//------------------------------------------------------------------------------------
+// Input Replays
+//
+// A session is its config (with the course seed) plus the input bits of every step.
+// Steps with the same input are stored as one run: a varint of the run length and
+// input bits, then a 16-bit state hash taken after the run's last step. Runs are
+// capped at one second, so playback catches a desync within a second of play.
+//
+// File layout: "FLRP", version byte, config, runs, a zero varint as terminator. The
+// version's top bit marks fixed-point physics, a build only plays back its own kind.
+//------------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------------
+// Types and Structures Definition
+//------------------------------------------------------------------------------------
+
+typedef enum ReplayStatus
+{
+    REPLAY_PLAYING = 0,
+    REPLAY_ENDED,                       // Every recorded step has been played
+    REPLAY_DESYNC,                      // A state hash did not match, the simulation diverged
+
+} ReplayStatus;
+
+typedef struct Replay Replay;
+
+//------------------------------------------------------------------------------------
+// Module Functions Declaration
+//------------------------------------------------------------------------------------
+
+// Recording
+Replay *replayCreate(const SimConfig *config);                          // Start recording a session played with config
+void replayRecord(Replay *replay, unsigned int input, const SimState *state);   // Append one step, state is the result of it
+bool replaySave(Replay *replay, const char *path);
+
+// Playback
+Replay *replayLoad(const char *path);                                   // NULL if missing or not a replay
+const SimConfig *replayConfig(const Replay *replay);                    // simInit with this before the first replayStep
+ReplayStatus replayStep(Replay *replay, SimState *state, int *events);  // Advance state by the next recorded step
+int replayTick(const Replay *replay);                                   // Steps played or recorded so far
+
+void replayDestroy(Replay *replay);
+
+#endif // REPLAY_H
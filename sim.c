@@ -0,0 +1,678 @@
+#include <stdlib.h>
+#include <string.h>
+#include "sim.h"
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+#elif defined(__SSE2__)
+    #include <emmintrin.h>
+#endif
+
+//------------------------------------------------------------------------------------
+// Defines Variables
+//------------------------------------------------------------------------------------
+
+#define SIM_RNG_MULTIPLIER 6364136223846793005ULL   // PCG32 LCG multiplier
+
+#if defined(SIM_FIXED_POINT)
+// Pipes ahead of a course about to be rebased must still fit Q16.16
+_Static_assert(SIM_PIPE_SPAN_MAX + (int) SIM_REBASE_DISTANCE + 2048 <= 32768, "SIM_PIPE_SPAN_MAX leaves no room for the lead-in");
+_Static_assert(SIM_MAX_PIPES * SIM_DIST_PIPE <= SIM_PIPE_SPAN_MAX, "SIM_MAX_PIPES pipes at SIM_DIST_PIPE overflow Q16.16, lower FLAPPY_MAX_PIPES");
+#endif
+
+//------------------------------------------------------------------------------------
+// Module Functions Declaration (local)
+//------------------------------------------------------------------------------------
+
+static void jump(SimState *state, unsigned int input, SimReal dt);  // Make character jumps
+static void advanceMap(SimState *state, SimReal dt);                // Scroll the backdrop and animate the bird
+static void randomPipe(SimState *state, int i);                     // Random pipes to different position
+static void recyclePipes(SimState *state);                          // Move off-screen pipes behind the tail
+static int randomValue(SimState *state, int min, int max);          // Uniform in [min, max] from the game's own generator
+
+// Scalar band test, the single-bird path and the tail of the batch kernels
+static inline bool bandHit(SimReal y, SimBand band, SimReal birdHeight)
+{
+    SimReal birdTop = y - birdHeight + SIM_REAL(15);
+    SimReal birdBottom = birdTop + birdHeight - SIM_REAL(10);
+
+    return (birdTop < band.top && birdBottom > band.topStart) || (birdTop < band.bottomEnd && birdBottom > band.bottom);
+}
+
+//------------------------------------------------------------------------------------
+// Initialize Simulation
+//------------------------------------------------------------------------------------
+
+SimConfig simDefaultConfig(void)
+{
+    SimConfig config;
+
+    config.backgroundWidth = 1217.0f;
+    config.foregroundWidth = 1680.0f;
+    config.foregroundHeight = 55.0f;
+
+    config.birdFrameWidth = 204.0f / 3;
+    config.birdHeight = 48.0f;
+
+    config.pipeWidth = 28.0f * 2.5f;
+    config.pipeHeight = 161.0f * 2.5f;
+
+    config.pipeCount = 5;
+    config.pipeDistance = SIM_DIST_PIPE;
+
+    config.seed = 1;
+    config.stream = 0;
+
+    return config;
+}
+
+void simInit(SimState *state, const SimConfig *config)
+{
+    SimMap *map = &state->map;
+    SimBird *bird = &state->bird;
+
+    state->config = *config;
+    simRngSeed(&state->rng, config->seed, config->stream);
+    if (state->config.pipeCount < 1) state->config.pipeCount = 1;
+    if (state->config.pipeCount > SIM_MAX_PIPES) state->config.pipeCount = SIM_MAX_PIPES;
+    if (!(state->config.pipeDistance > 0.0f)) state->config.pipeDistance = SIM_DIST_PIPE;  // Stacked pipes never recycle
+
+#if defined(SIM_FIXED_POINT)
+    // Fewer pipes ahead, at the asked spacing, rather than course positions that overflow
+    if (state->config.pipeDistance > SIM_PIPE_SPAN_MAX) state->config.pipeDistance = SIM_PIPE_SPAN_MAX;
+    if (state->config.pipeCount * state->config.pipeDistance > SIM_PIPE_SPAN_MAX) state->config.pipeCount = (int) (SIM_PIPE_SPAN_MAX / state->config.pipeDistance);
+#endif
+
+    // Main game and Score
+    //------------------------------------------
+    state->gameStart = true;
+    state->gameOver = false;
+    state->gameRun = 0;
+
+    state->currentFrame = 0;
+
+    state->score = 0;
+    state->speed = SIM_REAL(180);
+
+    // Map
+    //------------------------------------------
+    map->backgroundY = SIM_REAL(-500);
+    map->foregroundY = SIM_REAL(630);
+
+    map->scrollingBack = SIM_REAL(0);
+    map->scrollingFore = SIM_REAL(0);
+    map->framesTimer = SIM_REAL(0);
+    map->framesSpeed = 8;
+
+    map->ceiling = SIM_REAL(28);
+    map->ground = SIM_REAL(625);
+
+    // Bird
+    //------------------------------------------
+    bird->x = SIM_REAL(220);
+    bird->y = SIM_REAL(362.5);
+
+    bird->rotation = SIM_REAL(0);
+
+    bird->isJumping = 0;
+    bird->velocity = SIM_REAL(0);
+    bird->acceleration = SIM_REAL(0);
+    bird->gravity = SIM_REAL(100);
+
+    // Pipes
+    //------------------------------------------
+    state->topY_min = -simFromFloat(config->pipeHeight) + SIM_REAL(145);
+    state->topY_max = SIM_REAL(0);
+
+    state->scroll = SIM_REAL(0);
+    state->pipeHead = 0;
+    state->pipeNext = 0;
+
+    // Generate Pipes
+    for (int i = 0; i < state->config.pipeCount; i++)
+    {
+        state->pipes.x[i] = SIM_REAL(900) + (simFromFloat(state->config.pipeDistance) * i);
+        randomPipe(state, i);
+    }
+}
+
+//------------------------------------------------------------------------------------
+// Character's Jump Function
+//------------------------------------------------------------------------------------
+
+static void jump(SimState *state, unsigned int input, SimReal dt)
+{
+    SimBird *bird = &state->bird;
+
+    if (input & SIM_INPUT_JUMP)
+    {
+        bird->acceleration = SIM_REAL(10);
+        bird->velocity = simDiv(-bird->gravity, SIM_REAL(1.5));
+        bird->rotation = SIM_REAL(-35);
+    }
+    else
+    {
+        bird->acceleration += simMul(bird->gravity, dt);
+        bird->rotation += simMul(SIM_REAL(60), dt);
+    }
+
+    if (bird->acceleration >= bird->gravity) bird->acceleration = bird->gravity;
+
+    bird->velocity += simMul(bird->acceleration, dt) * 10;
+    bird->y += simMul(bird->velocity, dt) * 5;
+}
+
+//------------------------------------------------------------------------------------
+// Course Functions
+//------------------------------------------------------------------------------------
+
+static void advanceMap(SimState *state, SimReal dt)
+{
+    const SimConfig *config = &state->config;
+    SimMap *map = &state->map;
+
+    map->scrollingBack -= simMul(SIM_REAL(6), dt);
+    map->scrollingFore -= simMul(SIM_REAL(180), dt);
+    if (map->scrollingBack <= -simFromFloat(config->backgroundWidth) * 2) map->scrollingBack = SIM_REAL(0);
+    if (map->scrollingFore <= -simFromFloat(config->foregroundWidth) * 2) map->scrollingFore = SIM_REAL(0);
+
+    map->framesTimer += dt;
+    if (map->framesTimer >= SIM_REAL(1) / map->framesSpeed)
+    {
+        map->framesTimer = SIM_REAL(0);
+        state->currentFrame++;
+
+        if (state->currentFrame > 2) state->currentFrame = 0;
+    }
+}
+
+void simAdvanceCourse(SimState *state, float dt)
+{
+    SimReal step = simFromFloat(dt);
+
+    advanceMap(state, step);
+
+    state->scroll += simMul(state->speed, step);
+    recyclePipes(state);
+}
+
+//------------------------------------------------------------------------------------
+// Step Function
+//------------------------------------------------------------------------------------
+
+int simStep(SimState *state, unsigned int input, float dt)
+{
+    const SimConfig *config = &state->config;
+    SimMap *map = &state->map;
+    SimBird *bird = &state->bird;
+    SimReal step = simFromFloat(dt);
+    SimReal birdHeight = simFromFloat(config->birdHeight);
+    int events = 0;
+
+    // Hitboxes (pipes live in course coordinates, the bird's course x is its screen x plus the scroll)
+    //------------------------------------------
+    SimRect birdRec = {bird->x + SIM_REAL(5), bird->y - birdHeight + SIM_REAL(15), simFromFloat(config->birdFrameWidth) - SIM_REAL(10), birdHeight - SIM_REAL(10)};
+    SimRect bottomRec = {bird->x, map->foregroundY, simFromFloat(config->birdFrameWidth) - SIM_REAL(10), simFromFloat(config->foregroundHeight)};
+    SimReal birdY = bird->y;
+
+    if (!state->gameOver)
+    {
+        // Map Scrolling, Character and Pipe Position
+        //------------------------------------------
+        advanceMap(state, step);
+
+        // Character jumps and falls
+        //------------------------------------------
+        if (input & SIM_INPUT_JUMP)
+        {
+            bird->isJumping = 1;
+            events |= SIM_EVENT_JUMP;
+        }
+
+        if (bird->isJumping == 1)
+        {
+            state->gameRun = 1;
+            state->scroll += simMul(state->speed, step);
+            if (bird->y < map->ground && bird->y > map->ceiling) jump(state, input, step);
+        }
+
+        // Check for Collision and Regenerate pipes
+        //------------------------------------------
+
+        // Collision between the character and map's ground/ceiling
+        if (bandHit(birdY, simBoundsBand(state), birdHeight))
+        {
+            events |= SIM_EVENT_HIT;
+            state->gameOver = true;
+        }
+
+        // Regenerate pipes
+        recyclePipes(state);
+
+        SimPipes *pipes = &state->pipes;
+        SimReal birdLeft = birdRec.x + state->scroll;
+        SimReal birdRight = birdLeft + birdRec.width;
+        SimReal courseBirdX = bird->x + state->scroll;
+
+        // Broad phase: pipes are sorted by x, so start at the first unscored pipe and stop at the
+        // first one that starts right of the bird. That is one or two pipes whatever the count.
+        for (int n = 0; n < config->pipeCount; n++)
+        {
+            int i = (state->pipeNext + n) % config->pipeCount;
+            SimReal pipeRight = pipes->x[i] + simFromFloat(config->pipeWidth);
+
+            if (pipes->x[i] >= birdRight) break;
+
+            // Collision between the character and pipes
+            if (pipes->active[i] && pipeRight > birdLeft && bandHit(birdY, simPipeBand(state, i), birdHeight))
+            {
+                events |= SIM_EVENT_HIT;
+                state->gameOver = true;
+            }
+            else if ((pipeRight < birdLeft) && (pipeRight < courseBirdX) && !state->gameOver && pipes->active[i])
+            {
+                events |= SIM_EVENT_POINT;
+                state->score++;
+                pipes->active[i] = false;
+                if (i == state->pipeNext) state->pipeNext = (i + 1) % config->pipeCount;
+            }
+        }
+
+        // Speed
+        //------------------------------------------
+        if (state->score % 5 == 0 && state->score != 0) state->speed += simMul(SIM_REAL(18), step);  // Increases speed every 5 points gain
+    }
+    else
+    {
+        // Game Over
+        //------------------------------------------
+        if (bird->rotation <= SIM_REAL(30)) bird->rotation += simMul(SIM_REAL(240), step);
+        bird->acceleration += simMul(bird->gravity, step);
+
+        if (bird->acceleration >= bird->gravity) bird->acceleration = bird->gravity;
+
+        bird->velocity += simMul(bird->acceleration, step) * 10;
+#if defined(SIM_FIXED_POINT)
+        if (bird->velocity > SIM_REAL(4096)) bird->velocity = SIM_REAL(4096);  // Resting on the ground it would grow out of range
+#endif
+        bird->y += simMul(bird->velocity, step) * 5;
+
+        if (simCheckCollision(birdRec, bottomRec)) bird->y = bottomRec.y + SIM_REAL(15);
+
+        // Restart the Game
+        //------------------------------------------
+        if (input & SIM_INPUT_RESTART)
+        {
+            // The next course continues the random stream instead of replaying the seed
+            SimRng rng = state->rng;
+
+            simInit(state, config);
+            state->rng = rng;
+            events |= SIM_EVENT_RESTART;
+        }
+    }
+
+    return events;
+}
+
+//------------------------------------------------------------------------------------
+// Snapshot Functions
+//
+// Everything before pipes is one block, then each pipe array contributes only its
+// live slots. With the default five pipes a snapshot is about 240 bytes.
+//------------------------------------------------------------------------------------
+
+size_t simSnapshotSize(const SimState *state)
+{
+    size_t count = state->config.pipeCount;
+
+    return offsetof(SimState, pipes) + count * (3 * sizeof(SimReal) + sizeof(bool));
+}
+
+size_t simSave(const SimState *state, void *snapshot)
+{
+    unsigned char *out = snapshot;
+    size_t count = state->config.pipeCount;
+
+    memcpy(out, state, offsetof(SimState, pipes));
+    out += offsetof(SimState, pipes);
+    memcpy(out, state->pipes.x, count * sizeof(SimReal));
+    out += count * sizeof(SimReal);
+    memcpy(out, state->pipes.gapTop, count * sizeof(SimReal));
+    out += count * sizeof(SimReal);
+    memcpy(out, state->pipes.gapBottom, count * sizeof(SimReal));
+    out += count * sizeof(SimReal);
+    memcpy(out, state->pipes.active, count * sizeof(bool));
+    out += count * sizeof(bool);
+
+    return out - (unsigned char *) snapshot;
+}
+
+void simRestore(SimState *state, const void *snapshot)
+{
+    const unsigned char *in = snapshot;
+
+    memcpy(state, in, offsetof(SimState, pipes));
+    in += offsetof(SimState, pipes);
+
+    size_t count = state->config.pipeCount;
+
+    memcpy(state->pipes.x, in, count * sizeof(SimReal));
+    in += count * sizeof(SimReal);
+    memcpy(state->pipes.gapTop, in, count * sizeof(SimReal));
+    in += count * sizeof(SimReal);
+    memcpy(state->pipes.gapBottom, in, count * sizeof(SimReal));
+    in += count * sizeof(SimReal);
+    memcpy(state->pipes.active, in, count * sizeof(bool));
+}
+
+void simClone(SimState *dst, const SimState *src)
+{
+    size_t count = src->config.pipeCount;
+
+    memcpy(dst, src, offsetof(SimState, pipes));
+    memcpy(dst->pipes.x, src->pipes.x, count * sizeof(SimReal));
+    memcpy(dst->pipes.gapTop, src->pipes.gapTop, count * sizeof(SimReal));
+    memcpy(dst->pipes.gapBottom, src->pipes.gapBottom, count * sizeof(SimReal));
+    memcpy(dst->pipes.active, src->pipes.active, count * sizeof(bool));
+}
+
+//------------------------------------------------------------------------------------
+// State Hash (FNV-1a over the fields a step changes, padding bytes are never read)
+//------------------------------------------------------------------------------------
+
+static uint32_t hashWord(uint32_t hash, uint32_t word)
+{
+    for (int i = 0; i < 4; i++)
+    {
+        hash ^= (word >> (i * 8)) & 0xFF;
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+static uint32_t hashReal(uint32_t hash, SimReal value)
+{
+    uint32_t word;
+    memcpy(&word, &value, sizeof(word));
+
+    return hashWord(hash, word);
+}
+
+uint32_t simHash(const SimState *state)
+{
+    uint32_t hash = 2166136261u;
+
+    hash = hashReal(hash, state->bird.y);
+    hash = hashReal(hash, state->bird.rotation);
+    hash = hashReal(hash, state->bird.velocity);
+    hash = hashReal(hash, state->bird.acceleration);
+    hash = hashWord(hash, state->bird.isJumping);
+
+    hash = hashReal(hash, state->scroll);
+    hash = hashReal(hash, state->speed);
+    hash = hashReal(hash, state->map.framesTimer);
+    hash = hashWord(hash, state->pipeHead);
+    hash = hashWord(hash, state->pipeNext);
+    hash = hashWord(hash, state->score);
+    hash = hashWord(hash, state->gameOver);
+    hash = hashWord(hash, state->gameRun);
+
+    // The generator state stands in for every pipe it has placed
+    hash = hashWord(hash, (uint32_t) state->rng.state);
+    hash = hashWord(hash, (uint32_t) (state->rng.state >> 32));
+
+    return hash;
+}
+
+//------------------------------------------------------------------------------------
+// Collision Functions
+//------------------------------------------------------------------------------------
+
+bool simCheckCollision(SimRect rec1, SimRect rec2)
+{
+    return (rec1.x < (rec2.x + rec2.width) && (rec1.x + rec1.width) > rec2.x) &&
+           (rec1.y < (rec2.y + rec2.height) && (rec1.y + rec1.height) > rec2.y);
+}
+
+SimBand simPipeBand(const SimState *state, int i)
+{
+    SimBand band;
+
+    band.topStart = state->pipes.gapTop[i] - simFromFloat(state->config.pipeHeight);
+    band.top = state->pipes.gapTop[i];
+    band.bottom = state->pipes.gapBottom[i];
+    band.bottomEnd = state->pipes.gapBottom[i] + simFromFloat(state->config.pipeHeight);
+
+    return band;
+}
+
+SimBand simBoundsBand(const SimState *state)
+{
+    SimBand band;
+
+    band.topStart = SIM_REAL(-50);
+    band.top = SIM_REAL(-50) + simFromFloat(state->config.foregroundHeight);
+    band.bottom = state->map.foregroundY;
+    band.bottomEnd = state->map.foregroundY + simFromFloat(state->config.foregroundHeight);
+
+    return band;
+}
+
+//------------------------------------------------------------------------------------
+// Batch Collision Kernels
+//
+// Every bird shares one x, so once the caller knows the obstacle overlaps that x the
+// test is purely vertical: the bird box [y - h + 15, y + 5] against both band spans.
+//------------------------------------------------------------------------------------
+
+int simCollideBand(const SimReal *birdY, int count, SimBand band, SimReal birdHeight, unsigned char *hit)
+{
+    int hits = 0;
+    int i = 0;
+
+    // Each lane forms birdTop and birdBottom exactly as bandHit does, so a float build
+    // rounds the same whichever path a bird takes
+#if defined(SIM_FIXED_POINT) && defined(__AVX2__)
+    const __m256i height = _mm256_set1_epi32(birdHeight);
+    const __m256i fifteen = _mm256_set1_epi32(SIM_REAL(15));
+    const __m256i ten = _mm256_set1_epi32(SIM_REAL(10));
+    const __m256i topStart = _mm256_set1_epi32(band.topStart);
+    const __m256i top = _mm256_set1_epi32(band.top);
+    const __m256i bottom = _mm256_set1_epi32(band.bottom);
+    const __m256i bottomEnd = _mm256_set1_epi32(band.bottomEnd);
+
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256i y = _mm256_loadu_si256((const __m256i *) (birdY + i));
+        __m256i birdTop = _mm256_add_epi32(_mm256_sub_epi32(y, height), fifteen);
+        __m256i birdBottom = _mm256_sub_epi32(_mm256_add_epi32(birdTop, height), ten);
+        __m256i upper = _mm256_and_si256(_mm256_cmpgt_epi32(top, birdTop), _mm256_cmpgt_epi32(birdBottom, topStart));
+        __m256i lower = _mm256_and_si256(_mm256_cmpgt_epi32(bottomEnd, birdTop), _mm256_cmpgt_epi32(birdBottom, bottom));
+        int mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_or_si256(upper, lower)));
+
+        for (int k = 0; k < 8; k++) hit[i + k] = (mask >> k) & 1;
+        hits += __builtin_popcount(mask);
+    }
+#elif defined(SIM_FIXED_POINT) && defined(__SSE2__)
+    const __m128i height = _mm_set1_epi32(birdHeight);
+    const __m128i fifteen = _mm_set1_epi32(SIM_REAL(15));
+    const __m128i ten = _mm_set1_epi32(SIM_REAL(10));
+    const __m128i topStart = _mm_set1_epi32(band.topStart);
+    const __m128i top = _mm_set1_epi32(band.top);
+    const __m128i bottom = _mm_set1_epi32(band.bottom);
+    const __m128i bottomEnd = _mm_set1_epi32(band.bottomEnd);
+
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128i y = _mm_loadu_si128((const __m128i *) (birdY + i));
+        __m128i birdTop = _mm_add_epi32(_mm_sub_epi32(y, height), fifteen);
+        __m128i birdBottom = _mm_sub_epi32(_mm_add_epi32(birdTop, height), ten);
+        __m128i upper = _mm_and_si128(_mm_cmplt_epi32(birdTop, top), _mm_cmpgt_epi32(birdBottom, topStart));
+        __m128i lower = _mm_and_si128(_mm_cmplt_epi32(birdTop, bottomEnd), _mm_cmpgt_epi32(birdBottom, bottom));
+        int mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_or_si128(upper, lower)));
+
+        for (int k = 0; k < 4; k++) hit[i + k] = (mask >> k) & 1;
+        hits += (mask & 1) + ((mask >> 1) & 1) + ((mask >> 2) & 1) + ((mask >> 3) & 1);
+    }
+#elif defined(__AVX2__)
+    const __m256 height = _mm256_set1_ps(birdHeight);
+    const __m256 fifteen = _mm256_set1_ps(SIM_REAL(15));
+    const __m256 ten = _mm256_set1_ps(SIM_REAL(10));
+    const __m256 topStart = _mm256_set1_ps(band.topStart);
+    const __m256 top = _mm256_set1_ps(band.top);
+    const __m256 bottom = _mm256_set1_ps(band.bottom);
+    const __m256 bottomEnd = _mm256_set1_ps(band.bottomEnd);
+
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256 y = _mm256_loadu_ps(birdY + i);
+        __m256 birdTop = _mm256_add_ps(_mm256_sub_ps(y, height), fifteen);
+        __m256 birdBottom = _mm256_sub_ps(_mm256_add_ps(birdTop, height), ten);
+        __m256 upper = _mm256_and_ps(_mm256_cmp_ps(birdTop, top, _CMP_LT_OQ), _mm256_cmp_ps(birdBottom, topStart, _CMP_GT_OQ));
+        __m256 lower = _mm256_and_ps(_mm256_cmp_ps(birdTop, bottomEnd, _CMP_LT_OQ), _mm256_cmp_ps(birdBottom, bottom, _CMP_GT_OQ));
+        int mask = _mm256_movemask_ps(_mm256_or_ps(upper, lower));
+
+        for (int k = 0; k < 8; k++) hit[i + k] = (mask >> k) & 1;
+        hits += __builtin_popcount(mask);
+    }
+#elif defined(__SSE2__)
+    const __m128 height = _mm_set1_ps(birdHeight);
+    const __m128 fifteen = _mm_set1_ps(SIM_REAL(15));
+    const __m128 ten = _mm_set1_ps(SIM_REAL(10));
+    const __m128 topStart = _mm_set1_ps(band.topStart);
+    const __m128 top = _mm_set1_ps(band.top);
+    const __m128 bottom = _mm_set1_ps(band.bottom);
+    const __m128 bottomEnd = _mm_set1_ps(band.bottomEnd);
+
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 y = _mm_loadu_ps(birdY + i);
+        __m128 birdTop = _mm_add_ps(_mm_sub_ps(y, height), fifteen);
+        __m128 birdBottom = _mm_sub_ps(_mm_add_ps(birdTop, height), ten);
+        __m128 upper = _mm_and_ps(_mm_cmplt_ps(birdTop, top), _mm_cmpgt_ps(birdBottom, topStart));
+        __m128 lower = _mm_and_ps(_mm_cmplt_ps(birdTop, bottomEnd), _mm_cmpgt_ps(birdBottom, bottom));
+        int mask = _mm_movemask_ps(_mm_or_ps(upper, lower));
+
+        for (int k = 0; k < 4; k++) hit[i + k] = (mask >> k) & 1;
+        hits += (mask & 1) + ((mask >> 1) & 1) + ((mask >> 2) & 1) + ((mask >> 3) & 1);
+    }
+#endif
+
+    for (; i < count; i++)
+    {
+        hit[i] = bandHit(birdY[i], band, birdHeight);
+        hits += hit[i];
+    }
+
+    return hits;
+}
+
+//------------------------------------------------------------------------------------
+// Pipe Functions
+//------------------------------------------------------------------------------------
+
+static void recyclePipes(SimState *state)
+{
+    const SimConfig *config = &state->config;
+
+    SimPipes *pipes = &state->pipes;
+
+    // Pipes are ordered by x, so only the head can have left the screen
+    while (pipes->x[state->pipeHead] - state->scroll < -simFromFloat(config->pipeWidth))
+    {
+        int head = state->pipeHead;
+        int tail = (head + config->pipeCount - 1) % config->pipeCount;
+
+        pipes->x[head] = pipes->x[tail] + simFromFloat(config->pipeDistance);
+        randomPipe(state, head);
+        state->pipeHead = (head + 1) % config->pipeCount;
+        if (state->pipeNext == head) state->pipeNext = state->pipeHead;
+    }
+
+    // Keep course coordinates small so floats don't lose precision and Q16.16 doesn't overflow on long runs
+    if (state->scroll >= SIM_REAL(SIM_REBASE_DISTANCE))
+    {
+        for (int i = 0; i < config->pipeCount; i++) pipes->x[i] -= SIM_REAL(SIM_REBASE_DISTANCE);
+        state->scroll -= SIM_REAL(SIM_REBASE_DISTANCE);
+    }
+}
+
+static void randomPipe(SimState *state, int i)
+{
+    SimReal topY = simFromInt(randomValue(state, simToInt(state->topY_min), simToInt(state->topY_max)));
+
+    state->pipes.gapTop[i] = topY + simFromFloat(state->config.pipeHeight);
+    state->pipes.gapBottom[i] = topY + SIM_REAL(550);
+    state->pipes.active[i] = true;
+}
+
+static int randomValue(SimState *state, int min, int max)
+{
+    if (min > max)
+    {
+        int tmp = max;
+        max = min;
+        min = tmp;
+    }
+
+    return (int) simRngRange(&state->rng, (uint32_t) (max - min) + 1) + min;
+}
+
+//------------------------------------------------------------------------------------
+// Random Number Functions (PCG32, pcg-random.org)
+//------------------------------------------------------------------------------------
+
+void simRngSeed(SimRng *rng, uint64_t seed, uint64_t stream)
+{
+    rng->state = 0;
+    rng->inc = (stream << 1) | 1;
+    simRngNext(rng);
+    rng->state += seed;
+    simRngNext(rng);
+}
+
+uint32_t simRngNext(SimRng *rng)
+{
+    uint64_t old = rng->state;
+    rng->state = old * SIM_RNG_MULTIPLIER + rng->inc;
+
+    uint32_t xorShifted = (uint32_t) (((old >> 18) ^ old) >> 27);
+    uint32_t rotation = (uint32_t) (old >> 59);
+
+    return (xorShifted >> rotation) | (xorShifted << ((-rotation) & 31));
+}
+
+uint32_t simRngRange(SimRng *rng, uint32_t bound)
+{
+    // Reject the low values that would make some results more likely than others
+    uint32_t threshold = -bound % bound;
+
+    for (;;)
+    {
+        uint32_t value = simRngNext(rng);
+        if (value >= threshold) return value % bound;
+    }
+}
+
+void simRngAdvance(SimRng *rng, uint64_t delta)
+{
+    // Compose the LCG step with itself by squaring, one bit of delta at a time
+    uint64_t multiplier = SIM_RNG_MULTIPLIER, increment = rng->inc;
+    uint64_t accMultiplier = 1, accIncrement = 0;
+
+    while (delta > 0)
+    {
+        if (delta & 1)
+        {
+            accMultiplier *= multiplier;
+            accIncrement = accIncrement * multiplier + increment;
+        }
+        increment = (multiplier + 1) * increment;
+        multiplier *= multiplier;
+        delta >>= 1;
+    }
+
+    rng->state = accMultiplier * rng->state + accIncrement;
+}
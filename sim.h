@@ -0,0 +1,214 @@
+#ifndef SIM_H
+#define SIM_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+//------------------------------------------------------------------------------------
+// Headless Simulation Core
+//
+// Pure game logic: bird physics, pipe scrolling, collision and scoring. Nothing in
+// here touches the window, audio or textures, so it can be stepped without raylib.
+//------------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------------
+// Defines Variables
+//------------------------------------------------------------------------------------
+
+#ifndef SIM_MAX_PIPES
+#define SIM_MAX_PIPES 64                            // Pipe pool capacity, SimConfig.pipeCount picks how many are used
+#endif
+#define SIM_DIST_PIPE 300                           // Default distance between pipes
+
+#define SIM_SNAPSHOT_MAX_SIZE sizeof(SimState)      // Snapshot buffer size that fits any pipe count
+
+#define SIM_TICK_RATE 120                           // Fixed simulation steps per second
+#define SIM_DT (1.0f / SIM_TICK_RATE)               // Seconds per simulation step
+
+// Positions, speeds and times in the state are SimReal. The default build keeps them as
+// floats; SIM_FIXED_POINT makes them Q16.16 integers, so a step gives the same bits with
+// any compiler, optimisation level or float flags. Read them with simToFloat().
+#if defined(SIM_FIXED_POINT)
+typedef int32_t SimReal;                                    // Q16.16, range +-32768
+
+#define SIM_REAL(x) ((SimReal) ((x) * 65536.0 + (((x) < 0) ? -0.5 : 0.5)))   // Constant, rounded to nearest
+#define simFromFloat(x) ((SimReal) ((x) * 65536.0f))        // Scaling by a power of two is exact, the cast truncates
+#define simFromInt(x) ((SimReal) (x) * 65536)
+#define simToFloat(x) ((float) (x) * (1.0f / 65536))
+#define simToInt(x) ((int) ((x) / 65536))                   // Towards zero, like a float cast
+#define simMul(a, b) ((SimReal) (((int64_t) (a) * (b)) >> 16))
+#define simDiv(a, b) ((SimReal) (((int64_t) (a) * 65536) / (b)))
+
+#define SIM_REBASE_DISTANCE 8192.0f                         // Leaves room for SIM_MAX_PIPES pipes ahead in range
+#define SIM_PIPE_SPAN_MAX 22528                             // Largest pipeCount * pipeDistance, 2048 below 32768 - SIM_REBASE_DISTANCE for the lead-in
+#else
+typedef float SimReal;
+
+#define SIM_REAL(x) ((float) (x))
+#define simFromFloat(x) ((float) (x))
+#define simFromInt(x) ((float) (x))
+#define simToFloat(x) ((float) (x))
+#define simToInt(x) ((int) (x))
+#define simMul(a, b) ((a) * (b))
+#define simDiv(a, b) ((a) / (b))
+
+#define SIM_REBASE_DISTANCE 65536.0f                        // Course distance after which coordinates shift back to 0
+#endif
+
+// Input bits passed to simStep()
+#define SIM_INPUT_JUMP      0x01        // Flap (KEY_SPACE)
+#define SIM_INPUT_RESTART   0x02        // Restart after game over (KEY_ENTER)
+
+// Event bits returned by simStep()
+#define SIM_EVENT_JUMP      0x01        // Bird flapped
+#define SIM_EVENT_POINT     0x02        // A pipe was passed
+#define SIM_EVENT_HIT       0x04        // Bird hit a pipe, the ground or the ceiling
+#define SIM_EVENT_RESTART   0x08        // Game was reset
+
+//------------------------------------------------------------------------------------
+// Types and Structures Definition
+//------------------------------------------------------------------------------------
+
+typedef struct SimRect
+{
+    SimReal x, y;
+    SimReal width, height;
+
+} SimRect;
+
+// Sprite sizes the hitboxes are derived from (same numbers the textures have)
+typedef struct SimConfig
+{
+    float backgroundWidth;
+    float foregroundWidth;
+    float foregroundHeight;
+
+    float birdFrameWidth;
+    float birdHeight;
+
+    float pipeWidth;                    // Already scaled by the pipe draw scale
+    float pipeHeight;
+
+    int pipeCount;                      // Live pipes, 1 to SIM_MAX_PIPES
+    float pipeDistance;                 // Distance between consecutive pipes, SIM_DIST_PIPE if not positive
+
+    uint64_t seed;                      // Course seed, the same seed and stream give the same pipes
+    uint64_t stream;                    // Independent sequence per stream, e.g. one per parallel worker
+
+} SimConfig;
+
+// PCG32 generator: 64-bit LCG state with a permuted 32-bit output, same sequence on every platform
+typedef struct SimRng
+{
+    uint64_t state;
+    uint64_t inc;                       // Stream selector, always odd
+
+} SimRng;
+
+typedef struct SimMap
+{
+    SimReal backgroundY;
+    SimReal foregroundY;
+
+    SimReal scrollingBack;
+    SimReal scrollingFore;
+    SimReal framesTimer;                // Seconds since the last animation frame
+    int framesSpeed;                    // Animation frames per second
+
+    SimReal ceiling;
+    SimReal ground;
+
+} SimMap;
+
+typedef struct SimBird
+{
+    SimReal x, y;
+
+    SimReal rotation;
+
+    int isJumping;
+    SimReal velocity;
+    SimReal acceleration;
+    SimReal gravity;
+
+} SimBird;
+
+// Hot pipe data as parallel arrays; x is in course coordinates (screen x is x - SimState.scroll)
+typedef struct SimPipes
+{
+    SimReal x[SIM_MAX_PIPES];           // Left edge
+    SimReal gapTop[SIM_MAX_PIPES];      // Bottom edge of the top pipe
+    SimReal gapBottom[SIM_MAX_PIPES];   // Top edge of the bottom pipe
+    bool active[SIM_MAX_PIPES];         // Not passed yet
+
+} SimPipes;
+
+// Vertical extent of two obstacles sharing the bird's x range: one spanning
+// [topStart, top] and one spanning [bottom, bottomEnd]
+typedef struct SimBand
+{
+    SimReal topStart, top;
+    SimReal bottom, bottomEnd;
+
+} SimBand;
+
+typedef struct SimState
+{
+    SimConfig config;
+
+    SimMap map;
+    SimBird bird;
+    int pipeHead;                       // Ring buffer in pipes, ordered by x, oldest at pipeHead
+    int pipeNext;                       // First pipe the bird hasn't passed, where collision checks start
+    SimReal scroll;                     // Course distance travelled
+
+    bool gameStart;
+    bool gameOver;
+    int gameRun;
+
+    int currentFrame;
+
+    int score;
+    SimReal speed;                      // Pipe scrolling in pixels per second
+
+    SimReal topY_min;
+    SimReal topY_max;
+
+    SimRng rng;                         // Pipe generator, private to this game so games can run in parallel
+
+    // Last, so snapshots can stop after the config.pipeCount live slots of each array
+    SimPipes pipes;
+
+} SimState;
+
+//------------------------------------------------------------------------------------
+// Module Functions Declaration
+//------------------------------------------------------------------------------------
+
+SimConfig simDefaultConfig(void);                                       // Sizes of the shipped assets
+void simInit(SimState *state, const SimConfig *config);                 // Reset state for a new game
+int simStep(SimState *state, unsigned int input, float dt);             // Advance one step (normally SIM_DT), returns SIM_EVENT_* bits
+bool simCheckCollision(SimRect rec1, SimRect rec2);                     // Axis-aligned rectangle overlap
+void simAdvanceCourse(SimState *state, float dt);                       // Scroll the map and recycle pipes regardless of the bird, for population runs
+
+// Snapshots: the state is plain data, a snapshot is the state minus the unused pipe slots
+size_t simSnapshotSize(const SimState *state);                          // Bytes simSave writes for this state
+size_t simSave(const SimState *state, void *snapshot);                  // Returns the bytes written
+void simRestore(SimState *state, const void *snapshot);
+void simClone(SimState *dst, const SimState *src);                      // Copy only the live pipe slots
+
+uint32_t simHash(const SimState *state);                                // Hash of the evolving state, for desync checks
+
+void simRngSeed(SimRng *rng, uint64_t seed, uint64_t stream);           // Start a sequence
+uint32_t simRngNext(SimRng *rng);                                       // Next 32 random bits
+uint32_t simRngRange(SimRng *rng, uint32_t bound);                      // Unbiased value in [0, bound)
+void simRngAdvance(SimRng *rng, uint64_t delta);                        // Skip delta outputs in O(log delta)
+
+SimBand simPipeBand(const SimState *state, int i);                      // Pipe i as a band
+SimBand simBoundsBand(const SimState *state);                           // Ceiling and ground as a band
+
+// Batch kernels for many birds sharing one x position (SIMD where available)
+int simCollideBand(const SimReal *birdY, int count, SimBand band, SimReal birdHeight, unsigned char *hit);   // Sets hit[i], returns hits
+
+#endif // SIM_H
@@ -0,0 +1,128 @@
+#include <stdio.h>
+#include <math.h>
+#include "sim.h"
+
+//------------------------------------------------------------------------------------
+// Batch Collision Consistency Check
+//
+// Feeds heights on and next to every band edge through simCollideBand, once as full
+// SIMD lanes and once one bird at a time, which takes the scalar bandHit tail that
+// simStep uses. Both must agree bit for bit, or a population and a single-bird run of
+// the same course could disagree about a bird grazing a pipe.
+//------------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------------
+// Defines Variables
+//------------------------------------------------------------------------------------
+
+#define CHECK_BANDS 2000                // Random bands, each with every edge probed
+#define CHECK_STEPS 4                   // Neighbours probed on each side of an edge
+#define CHECK_LANES 16                  // Heights per batch call, covers AVX2 and SSE2 widths
+
+//------------------------------------------------------------------------------------
+// Module Functions Declaration (local)
+//------------------------------------------------------------------------------------
+
+static SimReal randomReal(SimRng *rng, float min, float max);      // Fractional values, where rounding differs
+static SimReal neighbour(SimReal value, int steps);                 // Next representable value, steps away
+static int checkBand(SimBand band, SimReal birdHeight, const SimReal *heights, int count);  // Mismatches found
+
+//------------------------------------------------------------------------------------
+// Program Main Entry Point
+//------------------------------------------------------------------------------------
+
+int main(void)
+{
+    SimRng rng;
+    simRngSeed(&rng, 11, 0);
+
+    int mismatches = 0;
+
+    for (int n = 0; n < CHECK_BANDS; n++)
+    {
+        SimBand band;
+        band.topStart = randomReal(&rng, -500.0f, 0.0f);
+        band.top = band.topStart + randomReal(&rng, 50.0f, 450.0f);
+        band.bottom = band.top + randomReal(&rng, 100.0f, 200.0f);
+        band.bottomEnd = band.bottom + randomReal(&rng, 50.0f, 450.0f);
+
+        SimReal birdHeight = (n % 2 == 0) ? SIM_REAL(48) : randomReal(&rng, 20.0f, 80.0f);
+
+        // Heights where birdTop = y - h + 15 or birdBottom = birdTop + h - 10 meets an edge
+        SimReal edges[4] = { band.topStart, band.top, band.bottom, band.bottomEnd };
+        SimReal heights[8 * (2 * CHECK_STEPS + 1)];
+        int count = 0;
+
+        for (int e = 0; e < 4; e++)
+        {
+            SimReal onTop = edges[e] + birdHeight - SIM_REAL(15);
+            SimReal onBottom = edges[e] - SIM_REAL(5);
+
+            for (int s = -CHECK_STEPS; s <= CHECK_STEPS; s++)
+            {
+                heights[count++] = neighbour(onTop, s);
+                heights[count++] = neighbour(onBottom, s);
+            }
+        }
+
+        mismatches += checkBand(band, birdHeight, heights, count);
+    }
+
+    if (mismatches > 0)
+    {
+        printf("collide_check: %d heights differ between the batch and scalar band tests\n", mismatches);
+        return 1;
+    }
+
+    printf("collide_check: %d bands agree\n", CHECK_BANDS);
+
+    return 0;
+}
+
+//------------------------------------------------------------------------------------
+// Check Functions
+//------------------------------------------------------------------------------------
+
+SimReal randomReal(SimRng *rng, float min, float max)
+{
+    float unit = simRngNext(rng) / 4294967296.0f;
+
+    return simFromFloat(min + (max - min) * unit);
+}
+
+SimReal neighbour(SimReal value, int steps)
+{
+#if defined(SIM_FIXED_POINT)
+    return value + steps;
+#else
+    for (; steps > 0; steps--) value = nextafterf(value, INFINITY);
+    for (; steps < 0; steps++) value = nextafterf(value, -INFINITY);
+
+    return value;
+#endif
+}
+
+int checkBand(SimBand band, SimReal birdHeight, const SimReal *heights, int count)
+{
+    int mismatches = 0;
+
+    // Every height in every lane position of a full batch
+    for (int start = 0; start < count; start++)
+    {
+        SimReal lanes[CHECK_LANES];
+        unsigned char batch[CHECK_LANES];
+
+        for (int k = 0; k < CHECK_LANES; k++) lanes[k] = heights[(start + k) % count];
+        simCollideBand(lanes, CHECK_LANES, band, birdHeight, batch);
+
+        for (int k = 0; k < CHECK_LANES; k++)
+        {
+            unsigned char single;
+            simCollideBand(&lanes[k], 1, band, birdHeight, &single);
+
+            if (batch[k] != single) mismatches++;
+        }
+    }
+
+    return mismatches;
+}
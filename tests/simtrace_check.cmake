@@ -0,0 +1,13 @@
+# Runs simtrace and compares its per-second hashes with a checked-in trace.
+# Usage: cmake -DSIMTRACE=<exe> -DSECONDS=<n> -DGOLDEN=<file> -P simtrace_check.cmake
+
+execute_process(COMMAND ${SIMTRACE} ${SECONDS} OUTPUT_VARIABLE trace RESULT_VARIABLE result)
+if (NOT result EQUAL 0)
+    message(FATAL_ERROR "simtrace exited with ${result}")
+endif ()
+
+file(READ ${GOLDEN} golden)
+if (NOT trace STREQUAL golden)
+    file(WRITE ${CMAKE_CURRENT_BINARY_DIR}/simtrace_actual.txt "${trace}")
+    message(FATAL_ERROR "simtrace output differs from ${GOLDEN}, see ${CMAKE_CURRENT_BINARY_DIR}/simtrace_actual.txt")
+endif ()
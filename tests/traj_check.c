@@ -0,0 +1,141 @@
+#include <stdio.h>
+#include <math.h>
+#include "sim.h"
+#include "trajectory.h"
+
+//------------------------------------------------------------------------------------
+// Trajectory Table Check
+//
+// Flaps the bird through simStep at sampled heights, records its arc, and steps it
+// to the first tick its hitbox leaves a sampled gap, starting the search at sampled
+// ticks into the arc (every (y, velocity) state the arc passes through). trajFirstHit
+// must name the same tick. Fixed-point builds must agree exactly; float builds may
+// only differ where the hitbox is within the table's tolerance of a gap edge.
+//------------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------------
+// Defines Variables
+//------------------------------------------------------------------------------------
+
+#define CHECK_FLAPS 4000                // Sampled flap heights and gaps
+#define CHECK_TICKS 200                 // Longest search window
+#define CHECK_TOLERANCE 0.01f           // Table drift from simStep allowed by tools/trajgen.c, in pixels
+
+//------------------------------------------------------------------------------------
+// Module Functions Declaration (local)
+//------------------------------------------------------------------------------------
+
+static float randomFloat(SimRng *rng, float min, float max);
+static int recordArc(SimReal flapY, SimReal *arc);                  // Bird y per tick after a flap, returns the ticks recorded
+static float edgeMargin(SimReal y, SimBand band, SimReal birdHeight);   // Distance of the hitbox from the nearer gap edge
+
+//------------------------------------------------------------------------------------
+// Program Main Entry Point
+//------------------------------------------------------------------------------------
+
+int main(void)
+{
+    SimConfig config = simDefaultConfig();
+    SimReal birdHeight = simFromFloat(config.birdHeight);
+
+    SimRng rng;
+    simRngSeed(&rng, 19, 0);
+
+    int checks = 0, nearEdge = 0, mismatches = 0;
+
+    for (int n = 0; n < CHECK_FLAPS; n++)
+    {
+        SimBand band;
+        band.top = simFromFloat(randomFloat(&rng, 60.0f, 420.0f));
+        band.bottom = band.top + simFromFloat(randomFloat(&rng, 100.0f, 200.0f));
+        band.topStart = band.top - simFromFloat(config.pipeHeight);
+        band.bottomEnd = band.bottom + simFromFloat(config.pipeHeight);
+
+        SimReal flapY = band.top + simFromFloat(randomFloat(&rng, -20.0f, 220.0f));
+
+        SimReal arc[CHECK_TICKS + 1];
+        int recorded = recordArc(flapY, arc);
+
+        for (int from = 0; from < 100; from += 7)
+        {
+            int to = from + (int) simRngRange(&rng, CHECK_TICKS - from);
+
+            // Step to the first tick in [from, to] the gap no longer holds the hitbox
+            int expected = -1;
+            bool known = true;
+            for (int k = from; k <= to; k++)
+            {
+                if (k >= recorded) { known = false; break; }     // Hit the ground or the ceiling first
+
+                SimReal birdTop = arc[k] - birdHeight + SIM_REAL(15);
+                SimReal birdBottom = birdTop + birdHeight - SIM_REAL(10);
+                if (birdTop < band.top || birdBottom > band.bottom) { expected = k; break; }
+            }
+            if (!known) continue;
+
+            int found = trajFirstHit(flapY, from, to, band, birdHeight);
+            checks++;
+
+            if (found == expected) continue;
+
+#if !defined(SIM_FIXED_POINT)
+            // The earlier of the two answers must sit on an edge to within the table's drift
+            int first = (found < 0) ? expected : (expected < 0) ? found : (found < expected) ? found : expected;
+            if (first < recorded && edgeMargin(arc[first], band, birdHeight) <= CHECK_TOLERANCE)
+            {
+                nearEdge++;
+                continue;
+            }
+#endif
+            if (mismatches++ < 10) printf("flap at %.4f, ticks %d-%d: simStep hits at %d, trajFirstHit at %d\n",
+                                          simToFloat(flapY), from, to, expected, found);
+        }
+    }
+
+    printf("traj_check: %d searches, %d within the tolerance of an edge, %d mismatches\n", checks, nearEdge, mismatches);
+
+    return (mismatches > 0) ? 1 : 0;
+}
+
+//------------------------------------------------------------------------------------
+// Check Functions
+//------------------------------------------------------------------------------------
+
+float randomFloat(SimRng *rng, float min, float max)
+{
+    return min + (max - min) * (simRngNext(rng) / 4294967296.0f);
+}
+
+int recordArc(SimReal flapY, SimReal *arc)
+{
+    SimConfig config = simDefaultConfig();
+    SimState state;
+
+    // As tools/trajgen.c does: pipes out of reach, the flap is the first step
+    simInit(&state, &config);
+    for (int i = 0; i < config.pipeCount; i++) state.pipes.x[i] = SIM_REAL(30000);
+
+    state.bird.y = flapY;
+    state.bird.isJumping = 1;
+    arc[0] = flapY;
+
+    for (int k = 1; k <= CHECK_TICKS; k++)
+    {
+        simStep(&state, (k == 1) ? SIM_INPUT_JUMP : 0, SIM_DT);
+        if (state.gameOver) return k;
+
+        arc[k] = state.bird.y;
+    }
+
+    return CHECK_TICKS + 1;
+}
+
+float edgeMargin(SimReal y, SimBand band, SimReal birdHeight)
+{
+    float birdTop = simToFloat(y - birdHeight + SIM_REAL(15));
+    float birdBottom = birdTop + simToFloat(birdHeight) - 10.0f;
+    float top = fabsf(birdTop - simToFloat(band.top));
+    float bottom = fabsf(birdBottom - simToFloat(band.bottom));
+
+    return (top < bottom) ? top : bottom;
+}
@@ -0,0 +1,276 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "raylib.h"
+#include "assetpack.h"
+
+//------------------------------------------------------------------------------------
+// Asset Packer
+//
+// Build-time tool: packs every sprite listed in atlas.h into one RGBA atlas, decodes
+// every sound listed in assetpack.h to PCM, and writes both out as C source that is
+// compiled into the game. Also writes a header with each sprite's atlas rectangle.
+//
+// Usage: assetpack <assetDir> <effectDir> <assetpack_data.c> <atlas_rects.h>
+//------------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------------
+// Defines Variables
+//------------------------------------------------------------------------------------
+
+#define ATLAS_WIDTH 2048
+
+//------------------------------------------------------------------------------------
+// Types and Structures Definition
+//------------------------------------------------------------------------------------
+
+typedef struct Sprite
+{
+    const char *name;
+    const char *file;
+
+    Image image;
+    int x, y;
+
+} Sprite;
+
+typedef struct Effect
+{
+    const char *name;
+    const char *file;
+
+    Wave wave;
+
+} Effect;
+
+#define ATLAS_SPRITE(id, file) { #id, file, { 0 }, 0, 0 },
+static Sprite sprites[ATLAS_COUNT] = { ATLAS_SPRITES(ATLAS_SPRITE) };
+#undef ATLAS_SPRITE
+
+#define PACK_SOUND(id, file) { #id, file, { 0 } },
+static Effect effects[PACK_SOUND_COUNT] = { PACK_SOUNDS(PACK_SOUND) };
+#undef PACK_SOUND
+
+//------------------------------------------------------------------------------------
+// Module Functions Declaration (local)
+//------------------------------------------------------------------------------------
+
+static bool fileExists(const char *dir, const char *file, char *path, int size);
+static int packSprites(void);                                   // Shelf-pack sprites, returns atlas height
+static void blitSprite(unsigned char *atlas, int atlasWidth, const Sprite *sprite);
+static void writeBytes(FILE *outFile, const char *name, const unsigned char *data, size_t size);
+static int writeSource(const char *path, const unsigned char *atlas, int atlasWidth, int atlasHeight);
+static int writeHeader(const char *path, int atlasWidth, int atlasHeight);
+
+//------------------------------------------------------------------------------------
+// Program Main Entry Point
+//------------------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    if (argc != 5)
+    {
+        fprintf(stderr, "Usage: %s <assetDir> <effectDir> <assetpack_data.c> <atlas_rects.h>\n", argv[0]);
+        return 1;
+    }
+
+    char path[1024];
+
+    // Decode sprites and sounds, a missing file packs empty
+    //------------------------------------------
+    for (int i = 0; i < ATLAS_COUNT; i++)
+    {
+        if (!fileExists(argv[1], sprites[i].file, path, sizeof(path))) continue;
+
+        sprites[i].image = LoadImage(path);
+        ImageFormat(&sprites[i].image, UNCOMPRESSED_R8G8B8A8);
+    }
+
+    for (int i = 0; i < PACK_SOUND_COUNT; i++)
+    {
+        if (!fileExists(argv[2], effects[i].file, path, sizeof(path))) continue;
+
+        effects[i].wave = LoadWave(path);
+    }
+
+    // Pack and compose the atlas
+    //------------------------------------------
+    int atlasHeight = packSprites();
+    if (atlasHeight == 0)
+    {
+        fprintf(stderr, "assetpack: no sprite found in %s, nothing to pack\n", argv[1]);
+        return 1;
+    }
+
+    unsigned char *pixels = calloc((size_t) ATLAS_WIDTH * atlasHeight, 4);
+    if (pixels == NULL)
+    {
+        fprintf(stderr, "assetpack: not enough memory for a %dx%d atlas\n", ATLAS_WIDTH, atlasHeight);
+        return 1;
+    }
+
+    for (int i = 0; i < ATLAS_COUNT; i++) if (sprites[i].image.data != NULL) blitSprite(pixels, ATLAS_WIDTH, &sprites[i]);
+
+    int result = writeSource(argv[3], pixels, ATLAS_WIDTH, atlasHeight);
+    if (result == 0) result = writeHeader(argv[4], ATLAS_WIDTH, atlasHeight);
+
+    // De-Initialization
+    //------------------------------------------
+    free(pixels);
+    for (int i = 0; i < ATLAS_COUNT; i++) if (sprites[i].image.data != NULL) UnloadImage(sprites[i].image);
+    for (int i = 0; i < PACK_SOUND_COUNT; i++) if (effects[i].wave.data != NULL) UnloadWave(effects[i].wave);
+
+    return result;
+}
+
+bool fileExists(const char *dir, const char *file, char *path, int size)
+{
+    snprintf(path, size, "%s/%s", dir, file);
+
+    FILE *probe = fopen(path, "rb");
+    if (probe == NULL)
+    {
+        fprintf(stderr, "assetpack: %s not found, packing it empty\n", path);
+        return false;
+    }
+    fclose(probe);
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------
+// Packing Functions
+//------------------------------------------------------------------------------------
+
+int packSprites(void)
+{
+    int order[ATLAS_COUNT];
+    for (int i = 0; i < ATLAS_COUNT; i++) order[i] = i;
+
+    // Tallest first keeps the shelves tight
+    for (int i = 1; i < ATLAS_COUNT; i++)
+    {
+        int key = order[i];
+        int j = i - 1;
+        while (j >= 0 && sprites[order[j]].image.height < sprites[key].image.height)
+        {
+            order[j + 1] = order[j];
+            j--;
+        }
+        order[j + 1] = key;
+    }
+
+    int shelfX = 0, shelfY = 0, shelfHeight = 0;
+
+    for (int i = 0; i < ATLAS_COUNT; i++)
+    {
+        Sprite *sprite = &sprites[order[i]];
+        if (sprite->image.data == NULL) continue;
+
+        if (shelfX + sprite->image.width > ATLAS_WIDTH)
+        {
+            shelfX = 0;
+            shelfY += shelfHeight + ATLAS_PADDING;
+            shelfHeight = 0;
+        }
+
+        sprite->x = shelfX;
+        sprite->y = shelfY;
+
+        shelfX += sprite->image.width + ATLAS_PADDING;
+        if (sprite->image.height > shelfHeight) shelfHeight = sprite->image.height;
+    }
+
+    // No power-of-two rounding: every row ends up in the executable
+    return shelfY + shelfHeight;
+}
+
+void blitSprite(unsigned char *atlas, int atlasWidth, const Sprite *sprite)
+{
+    const unsigned char *src = sprite->image.data;
+    size_t rowBytes = (size_t) sprite->image.width * 4;
+
+    for (int y = 0; y < sprite->image.height; y++)
+    {
+        memcpy(atlas + ((size_t) (sprite->y + y) * atlasWidth + sprite->x) * 4, src + y * rowBytes, rowBytes);
+    }
+}
+
+//------------------------------------------------------------------------------------
+// Output Functions
+//------------------------------------------------------------------------------------
+
+void writeBytes(FILE *outFile, const char *name, const unsigned char *data, size_t size)
+{
+    fprintf(outFile, "static const unsigned char %s[%zu] =\n{\n", name, size);
+    for (size_t i = 0; i < size; i++)
+    {
+        fprintf(outFile, (i % 32 == 31) ? "%u,\n" : "%u,", data[i]);
+    }
+    fprintf(outFile, "\n};\n\n");
+}
+
+int writeSource(const char *path, const unsigned char *atlas, int atlasWidth, int atlasHeight)
+{
+    FILE *outFile = fopen(path, "w");
+    if (outFile == NULL)
+    {
+        fprintf(stderr, "assetpack: could not write %s\n", path);
+        return 1;
+    }
+
+    fprintf(outFile, "// Generated by tools/assetpack.c, do not edit\n\n#include \"assetpack.h\"\n\n");
+
+    writeBytes(outFile, "atlasPixels", atlas, (size_t) atlasWidth * atlasHeight * 4);
+
+    for (int i = 0; i < PACK_SOUND_COUNT; i++)
+    {
+        const Wave *wave = &effects[i].wave;
+        char name[64];
+
+        if (wave->data == NULL) continue;
+
+        snprintf(name, sizeof(name), "samples%d", i);
+        writeBytes(outFile, name, wave->data, (size_t) wave->sampleCount * wave->sampleSize / 8);
+    }
+
+    fprintf(outFile, "const AssetPack assetPack =\n{\n");
+    fprintf(outFile, "    { %d, %d, atlasPixels },\n    {\n", atlasWidth, atlasHeight);
+    for (int i = 0; i < PACK_SOUND_COUNT; i++)
+    {
+        const Wave *wave = &effects[i].wave;
+        char samples[64] = "0";
+
+        if (wave->data != NULL) snprintf(samples, sizeof(samples), "samples%d", i);
+
+        fprintf(outFile, "        { %u, %u, %u, %u, %s },    // %s\n", wave->sampleCount, wave->sampleRate,
+                wave->sampleSize, wave->channels, samples, effects[i].name);
+    }
+    fprintf(outFile, "    }\n};\n");
+
+    fclose(outFile);
+    return 0;
+}
+
+int writeHeader(const char *path, int atlasWidth, int atlasHeight)
+{
+    FILE *outFile = fopen(path, "w");
+    if (outFile == NULL)
+    {
+        fprintf(stderr, "assetpack: could not write %s\n", path);
+        return 1;
+    }
+
+    fprintf(outFile, "// Generated by tools/assetpack.c, do not edit\n\n");
+    fprintf(outFile, "#define ATLAS_WIDTH %d\n#define ATLAS_HEIGHT %d\n\n", atlasWidth, atlasHeight);
+    fprintf(outFile, "static const AtlasRect atlasRects[ATLAS_COUNT] =\n{\n");
+    for (int i = 0; i < ATLAS_COUNT; i++)
+    {
+        fprintf(outFile, "    { %d, %d, %d, %d },    // %s\n", sprites[i].x, sprites[i].y,
+                sprites[i].image.width, sprites[i].image.height, sprites[i].name);
+    }
+    fprintf(outFile, "};\n");
+
+    fclose(outFile);
+    return 0;
+}
@@ -0,0 +1,68 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "autopilot.h"
+
+//------------------------------------------------------------------------------------
+// Autopilot Benchmark
+//
+// Lets the autopilot play headless for a stretch of game time, restarting after each
+// crash, and reports the search rate and how well it played.
+//
+// Usage: autopilotbench [seconds of play] [threads] [budget ms]
+//------------------------------------------------------------------------------------
+
+static double now(void)
+{
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+
+    return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+int main(int argc, char *argv[])
+{
+    AutopilotConfig config = autopilotDefaultConfig();
+    int seconds = (argc > 1) ? atoi(argv[1]) : 120;
+    if (argc > 2) config.threads = atoi(argv[2]);
+    if (argc > 3) config.budget = atof(argv[3]) / 1000.0;
+
+    Autopilot *pilot = autopilotCreate(&config);
+    if (pilot == NULL)
+    {
+        fprintf(stderr, "autopilotbench: could not start the autopilot\n");
+        return 1;
+    }
+
+    SimConfig simConfig = simDefaultConfig();
+    SimState state;
+    simInit(&state, &simConfig);
+
+    int points = 0, crashes = 0;
+    double searchTime = 0.0, slowest = 0.0;
+
+    for (int tick = 0; tick < seconds * SIM_TICK_RATE; tick++)
+    {
+        double start = now();
+        unsigned int input = autopilotInput(pilot, &state);
+        double spent = now() - start;
+
+        searchTime += spent;
+        if (spent > slowest) slowest = spent;
+
+        if (state.gameOver) input = SIM_INPUT_RESTART;
+
+        int events = simStep(&state, input, SIM_DT);
+        if (events & SIM_EVENT_POINT) points++;
+        if (events & SIM_EVENT_HIT) crashes++;
+    }
+
+    long long nodes = autopilotNodes(pilot);
+
+    printf("%lld nodes in %.3f s of search: %.2f M nodes/s\n", nodes, searchTime, nodes / searchTime / 1e6);
+    printf("slowest decision %.2f ms, %d points and %d crashes in %d s of play\n", slowest * 1000.0, points, crashes, seconds);
+
+    autopilotDestroy(pilot);
+
+    return 0;
+}
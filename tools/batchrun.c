@@ -0,0 +1,109 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "batch.h"
+
+//------------------------------------------------------------------------------------
+// Batch Runner Driver
+//
+// Plays one scripted episode per seed on every core and prints the throughput and a
+// score summary. Each episode aims a different height under the next gap.
+//
+// Usage: batchrun <episodes> [threads] [maxSteps]
+//------------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------------
+// Defines Variables
+//------------------------------------------------------------------------------------
+
+#define MARGIN_COUNT 8
+
+//------------------------------------------------------------------------------------
+// Module Functions Declaration (local)
+//------------------------------------------------------------------------------------
+
+static unsigned int aimBelowGap(const SimState *state, void *context);     // Flap when below margin pixels over the bottom pipe
+
+//------------------------------------------------------------------------------------
+// Program Main Entry Point
+//------------------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    static float margins[MARGIN_COUNT] = { 40, 50, 60, 70, 80, 90, 100, 110 };
+
+    if (argc < 2)
+    {
+        fprintf(stderr, "Usage: %s <episodes> [threads] [maxSteps]\n", argv[0]);
+        return 1;
+    }
+
+    int count = atoi(argv[1]);
+    int threads = (argc > 2) ? atoi(argv[2]) : batchDefaultThreads();
+    int maxSteps = (argc > 3) ? atoi(argv[3]) : 60 * SIM_TICK_RATE;
+
+    BatchJob *jobs = malloc(count * sizeof(BatchJob));
+    BatchResult *results = malloc(count * sizeof(BatchResult));
+    if (count < 1 || jobs == NULL || results == NULL)
+    {
+        fprintf(stderr, "batchrun: cannot run %d episodes\n", count);
+        return 1;
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        jobs[i].config = simDefaultConfig();
+        jobs[i].config.seed = 1;
+        jobs[i].config.stream = i;              // One course per episode from a single seed
+        jobs[i].controller = aimBelowGap;
+        jobs[i].context = &margins[i % MARGIN_COUNT];
+        jobs[i].maxSteps = maxSteps;
+    }
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    bool ok = batchRun(jobs, count, results, threads);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    // Summary
+    //------------------------------------------
+    double seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    long long steps = 0, scoreSum = 0;
+    int best = 0, survived = 0;
+
+    for (int i = 0; i < count; i++)
+    {
+        steps += results[i].steps;
+        scoreSum += results[i].score;
+        if (results[i].score > best) best = results[i].score;
+        if (!results[i].crashed) survived++;
+    }
+
+    printf("%d episodes on %d threads in %.3f s: %.1f M steps/s\n", count, threads, seconds, steps / seconds / 1e6);
+    printf("mean score %.2f, best %d, %d reached %d steps\n", (double) scoreSum / count, best, survived, maxSteps);
+
+    free(jobs);
+    free(results);
+
+    return ok ? 0 : 1;
+}
+
+unsigned int aimBelowGap(const SimState *state, void *context)
+{
+    float margin = *(const float *) context;
+    SimReal gapBottom = state->map.ground;
+
+    if (!state->bird.isJumping) return SIM_INPUT_JUMP;
+
+    for (int n = 0; n < state->config.pipeCount; n++)
+    {
+        int i = (state->pipeHead + n) % state->config.pipeCount;
+        if (state->pipes.active[i])
+        {
+            gapBottom = state->pipes.gapBottom[i];
+            break;
+        }
+    }
+
+    return (state->bird.y > gapBottom - simFromFloat(margin)) ? SIM_INPUT_JUMP : 0;
+}
@@ -0,0 +1,442 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "population.h"
+#include "render.h"
+#include "hiscore.h"
+
+#if defined(BENCH_ASSETS)
+    #include "atlas_rects.h"            // Generated by tools/assetpack.c
+#endif
+
+//------------------------------------------------------------------------------------
+// Benchmark Suite
+//
+// Times the simulation step, the population step, the population step again over
+// growing pipe counts (the collision broad phase is the part that sees them), the
+// software renderer and its sprite resampling, and the high score store. Inputs come
+// from fixed seeds and every case runs a warmup first, then BENCH_REPEATS timed runs,
+// reporting the median. One JSON object per line on stdout:
+//
+//   {"bench":"collide","birds":1024,"pipes":8,"value":9.7e+07,"unit":"bird-steps/s"}
+//
+// Without the asset pack (no raylib) the renderer draws a synthetic atlas with the
+// shipped sprite sizes, marked "atlas":"synthetic".
+//
+// Usage: flappy_bench [name filter]
+//------------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------------
+// Defines Variables
+//------------------------------------------------------------------------------------
+
+#define BENCH_REPEATS 5                 // Timed runs per case, the median is reported
+#define BENCH_SEED 2024
+#define BENCH_HISCORE_FILE "flappy_bench_hiscore.txt"
+
+//------------------------------------------------------------------------------------
+// Types and Structures Definition
+//------------------------------------------------------------------------------------
+
+typedef struct BenchAtlas
+{
+    PackedImage image;
+    const AtlasRect *rects;
+    const char *name;                   // "packed" or "synthetic"
+
+} BenchAtlas;
+
+//------------------------------------------------------------------------------------
+// Global Variables Declaration
+//------------------------------------------------------------------------------------
+
+static const char *filter;              // Only benches whose name contains it
+
+//------------------------------------------------------------------------------------
+// Module Functions Declaration (local)
+//------------------------------------------------------------------------------------
+
+static double now(void);
+static double median(double *values, int count);
+static bool selected(const char *bench);
+static void report(const char *bench, const char *params, double value, const char *unit);
+static SimReal nextGapBottom(const SimState *state);               // Bottom of the first gap not passed yet
+static unsigned int script(const SimState *state, SimRng *rng);    // Flap under the gap, with random slips
+
+static void benchSimStep(void);
+static void benchPopulation(const char *bench, int birds, int pipes);    // pipes 0 keeps the default course
+static void benchRender(const BenchAtlas *atlas, RenderFormat format, int width, int height, int frames);
+static void benchHiScore(void);
+static BenchAtlas loadAtlas(void);      // The packed atlas when built in, a synthetic one otherwise
+
+//------------------------------------------------------------------------------------
+// Program Main Entry Point
+//------------------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    static const int populationBirds[] = { 1, 100, 1000, 10000 };
+    static const int collideBirds[] = { 1, 1024, 16384 };
+    static const int collidePipes[] = { 1, 8, 64 };
+
+    filter = (argc > 1) ? argv[1] : NULL;
+
+    if (selected("sim_step")) benchSimStep();
+
+    for (size_t i = 0; i < sizeof(populationBirds) / sizeof(populationBirds[0]); i++)
+    {
+        if (selected("population_step")) benchPopulation("population_step", populationBirds[i], 0);
+    }
+
+    for (size_t i = 0; i < sizeof(collideBirds) / sizeof(collideBirds[0]); i++)
+    {
+        for (size_t j = 0; j < sizeof(collidePipes) / sizeof(collidePipes[0]); j++)
+        {
+            if (selected("collide") && collidePipes[j] <= SIM_MAX_PIPES) benchPopulation("collide", collideBirds[i], collidePipes[j]);
+        }
+    }
+
+    if (selected("render_frames") || selected("render_sprites") || selected("render_prep"))
+    {
+        BenchAtlas atlas = loadAtlas();
+
+        benchRender(&atlas, RENDER_GRAY, 84, 84, 20000);
+        benchRender(&atlas, RENDER_RGBA, RENDER_SCREEN_WIDTH, RENDER_SCREEN_HEIGHT, 1000);
+
+#if !defined(BENCH_ASSETS)
+        free((void *) atlas.image.pixels);
+#endif
+    }
+
+    if (selected("hiscore")) benchHiScore();
+
+    return 0;
+}
+
+//------------------------------------------------------------------------------------
+// Simulation Benchmarks
+//------------------------------------------------------------------------------------
+
+void benchSimStep(void)
+{
+    const int warmup = 20000, steps = 200000;
+    double rates[BENCH_REPEATS];
+
+    SimConfig config = simDefaultConfig();
+    config.seed = BENCH_SEED;
+
+    for (int r = 0; r < BENCH_REPEATS; r++)
+    {
+        SimState state;
+        SimRng rng;
+
+        simInit(&state, &config);
+        simRngSeed(&rng, BENCH_SEED, 0);
+
+        for (int i = 0; i < warmup; i++) simStep(&state, script(&state, &rng), SIM_DT);
+
+        // Inputs are drawn up front so only the step is timed
+        unsigned char *inputs = malloc(steps);
+        if (inputs == NULL) return;
+
+        SimState probe = state;
+        SimRng probeRng = rng;
+        for (int i = 0; i < steps; i++)
+        {
+            inputs[i] = (unsigned char) script(&probe, &probeRng);
+            simStep(&probe, inputs[i], SIM_DT);
+        }
+
+        double start = now();
+        for (int i = 0; i < steps; i++) simStep(&state, inputs[i], SIM_DT);
+        rates[r] = steps / (now() - start);
+
+        free(inputs);
+    }
+
+    report("sim_step", "\"birds\":1", median(rates, BENCH_REPEATS), "steps/s");
+}
+
+void benchPopulation(const char *bench, int birds, int pipes)
+{
+    const int steps = (birds >= 1000) ? 2000 : 20000;
+    double rates[BENCH_REPEATS];
+    char params[64];
+
+    SimConfig config = simDefaultConfig();
+    config.seed = BENCH_SEED;
+    if (pipes > 0) config.pipeCount = pipes;
+
+    Population *pop = populationCreate(birds);
+    unsigned char *flap = calloc(birds, 1);
+    if (pop == NULL || flap == NULL) return;
+
+    for (int r = 0; r < BENCH_REPEATS + 1; r++)                     // The first run is the warmup
+    {
+        populationReset(pop, &config, birds);
+
+        long long birdSteps = 0;
+        double start = now();
+
+        for (int i = 0; i < steps; i++)
+        {
+            if (pop->alive == 0) populationReset(pop, &config, birds);
+
+            // Every bird aims a different height above the bottom pipe, as simtrace does
+            SimReal gapBottom = nextGapBottom(&pop->world);
+            for (int b = 0; b < pop->alive; b++)
+            {
+                int bird = pop->id[b];
+                flap[bird] = pop->y[b] > gapBottom - SIM_REAL(20) - simFromInt(bird * 37 % 101);
+            }
+
+            birdSteps += pop->alive;
+            populationStep(pop, flap, SIM_DT);
+        }
+
+        if (r > 0) rates[r - 1] = birdSteps / (now() - start);
+    }
+
+    if (pipes > 0) snprintf(params, sizeof(params), "\"birds\":%d,\"pipes\":%d", birds, pipes);
+    else snprintf(params, sizeof(params), "\"birds\":%d", birds);
+    report(bench, params, median(rates, BENCH_REPEATS), "bird-steps/s");
+
+    free(flap);
+    populationDestroy(pop);
+}
+
+//------------------------------------------------------------------------------------
+// Rendering Benchmarks
+//------------------------------------------------------------------------------------
+
+void benchRender(const BenchAtlas *atlas, RenderFormat format, int width, int height, int frames)
+{
+    double loads[BENCH_REPEATS], rates[BENCH_REPEATS], sprites[BENCH_REPEATS];
+    char params[128];
+
+    RenderConfig config = renderDefaultConfig();
+    config.width = width;
+    config.height = height;
+    config.format = format;
+
+    unsigned char *pixels = malloc((size_t) width * height * 4);
+    if (pixels == NULL) return;
+
+    SimConfig simConfig = simDefaultConfig();
+    simConfig.seed = BENCH_SEED;
+
+    for (int r = 0; r < BENCH_REPEATS + 1; r++)
+    {
+        // Preparation: resampling the sprites to the output scale
+        double start = now();
+        Renderer *renderer = renderCreate(&config, &atlas->image, atlas->rects);
+        double loaded = now() - start;
+
+        if (renderer == NULL) break;
+
+        SimState state;
+        SimRng rng;
+        simInit(&state, &simConfig);
+        simRngSeed(&rng, BENCH_SEED, 0);
+
+        double spent = 0.0;
+        long long drawn = 0;
+
+        for (int i = 0; i < frames; i++)
+        {
+            simStep(&state, script(&state, &rng), SIM_DT);
+
+            // Backgrounds, foregrounds and bird, plus both halves of every pipe on screen
+            drawn += 5;
+            for (int n = 0; (state.gameRun || state.gameOver) && n < state.config.pipeCount; n++)
+            {
+                int p = (state.pipeHead + n) % state.config.pipeCount;
+                if (simToFloat(state.pipes.x[p] - state.scroll) > RENDER_SCREEN_WIDTH) break;
+                drawn += 2;
+            }
+
+            start = now();
+            renderFrame(renderer, &state, pixels);
+            spent += now() - start;
+        }
+
+        renderDestroy(renderer);
+
+        if (r > 0)
+        {
+            loads[r - 1] = loaded * 1000.0;
+            rates[r - 1] = frames / spent;
+            sprites[r - 1] = drawn / spent;
+        }
+    }
+
+    snprintf(params, sizeof(params), "\"width\":%d,\"height\":%d,\"format\":\"%s\",\"atlas\":\"%s\"",
+             width, height, (format == RENDER_GRAY) ? "gray" : "rgba", atlas->name);
+
+    if (selected("render_frames")) report("render_frames", params, median(rates, BENCH_REPEATS), "frames/s");
+    if (selected("render_sprites")) report("render_sprites", params, median(sprites, BENCH_REPEATS), "sprites/s");
+    if (selected("render_prep")) report("render_prep", params, median(loads, BENCH_REPEATS), "ms");
+
+    free(pixels);
+}
+
+BenchAtlas loadAtlas(void)
+{
+#if defined(BENCH_ASSETS)
+    return (BenchAtlas) { assetPack.atlas, atlasRects, "packed" };
+#else
+    // Same layout and sprite sizes as the packed atlas: opaque backdrop sprites, pipes
+    // with a transparent border column and an elliptical bird
+    static AtlasRect rects[ATLAS_COUNT] =
+    {
+        [ATLAS_BACKGROUND] = { 0, 0, 1217, 504 },
+        [ATLAS_FOREGROUND] = { 0, 506, 1680, 55 },
+        [ATLAS_BIRD] = { 1682, 506, 204, 48 },
+        [ATLAS_TOP_PIPE] = { 1219, 0, 28, 161 },
+        [ATLAS_BOTTOM_PIPE] = { 1249, 0, 28, 161 },
+    };
+    const int width = 2048, height = 561;
+
+    unsigned char *pixels = calloc((size_t) width * height, 4);
+    SimRng rng;
+    simRngSeed(&rng, BENCH_SEED, 2);
+
+    for (int sprite = 0; sprite < ATLAS_COUNT && pixels != NULL; sprite++)
+    {
+        AtlasRect rect = rects[sprite];
+
+        for (int y = 0; y < (int) rect.height; y++)
+        {
+            for (int x = 0; x < (int) rect.width; x++)
+            {
+                unsigned char *texel = pixels + (((size_t) rect.y + y) * width + (size_t) rect.x + x) * 4;
+                float u = (x % 68 - 34) / 34.0f, v = (y - 24) / 24.0f;
+                bool opaque = true;
+
+                if (sprite == ATLAS_TOP_PIPE || sprite == ATLAS_BOTTOM_PIPE) opaque = (x > 0 && x < (int) rect.width - 1);
+                if (sprite == ATLAS_BIRD) opaque = (u * u + v * v < 1.0f);
+
+                uint32_t color = simRngNext(&rng);
+                memcpy(texel, &color, 3);
+                texel[3] = opaque ? 255 : 0;
+            }
+        }
+    }
+
+    return (BenchAtlas) { { width, height, pixels }, rects, "synthetic" };
+#endif
+}
+
+//------------------------------------------------------------------------------------
+// High Score Store Benchmark
+//------------------------------------------------------------------------------------
+
+void benchHiScore(void)
+{
+    const int submits = 100000, writes = 20;
+    double submitCosts[BENCH_REPEATS], writeCosts[BENCH_REPEATS];
+
+    // A fresh store, created here since the store announces files it creates on stdout
+    FILE *file = fopen(BENCH_HISCORE_FILE, "w");
+    if (file == NULL) return;
+    fputs("0", file);
+    fclose(file);
+
+    for (int r = 0; r < BENCH_REPEATS + 1; r++)
+    {
+        // Caller side: new bests only queue a write, the writer thread collapses them
+        HiScoreStore *store = hiScoreStoreOpen(BENCH_HISCORE_FILE);
+        if (store == NULL) return;
+
+        int base = hiScoreStoreGet(store);
+        double start = now();
+        for (int i = 1; i <= submits; i++) hiScoreStoreSubmit(store, base + i);
+        double submitted = now() - start;
+
+        hiScoreStoreClose(store);
+
+        // Durable write: open, one new best and close, which waits for the temp file + rename
+        start = now();
+        for (int i = 0; i < writes; i++)
+        {
+            store = hiScoreStoreOpen(BENCH_HISCORE_FILE);
+            hiScoreStoreSubmit(store, hiScoreStoreGet(store) + 1);
+            hiScoreStoreClose(store);
+        }
+        double written = now() - start;
+
+        if (r > 0)
+        {
+            submitCosts[r - 1] = submitted / submits * 1e9;
+            writeCosts[r - 1] = written / writes * 1000.0;
+        }
+    }
+
+    report("hiscore_submit", "\"calls\":100000", median(submitCosts, BENCH_REPEATS), "ns/call");
+    report("hiscore_write", "\"writes\":20", median(writeCosts, BENCH_REPEATS), "ms/write");
+
+    remove(BENCH_HISCORE_FILE);
+}
+
+//------------------------------------------------------------------------------------
+// Helper Functions
+//------------------------------------------------------------------------------------
+
+double now(void)
+{
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+
+    return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+double median(double *values, int count)
+{
+    // Insertion sort, a handful of values
+    for (int i = 1; i < count; i++)
+    {
+        double value = values[i];
+        int j = i - 1;
+        for (; j >= 0 && values[j] > value; j--) values[j + 1] = values[j];
+        values[j + 1] = value;
+    }
+
+    return (count % 2) ? values[count / 2] : (values[count / 2 - 1] + values[count / 2]) / 2;
+}
+
+bool selected(const char *bench)
+{
+    return (filter == NULL) || (strstr(bench, filter) != NULL);
+}
+
+void report(const char *bench, const char *params, double value, const char *unit)
+{
+    printf("{\"bench\":\"%s\",%s,\"value\":%.6g,\"unit\":\"%s\"}\n", bench, params, value, unit);
+    fflush(stdout);
+}
+
+SimReal nextGapBottom(const SimState *state)
+{
+    for (int n = 0; n < state->config.pipeCount; n++)
+    {
+        int i = (state->pipeNext + n) % state->config.pipeCount;
+        if (state->pipes.active[i]) return state->pipes.gapBottom[i];
+    }
+
+    return state->map.ground;
+}
+
+unsigned int script(const SimState *state, SimRng *rng)
+{
+    uint32_t roll = simRngRange(rng, 1000);
+
+    if (state->gameOver) return (roll < 20) ? SIM_INPUT_RESTART : 0;
+    if (!state->bird.isJumping) return (roll < 50) ? SIM_INPUT_JUMP : 0;
+
+    // Mostly hold under the gap, now and then slip so the session also crashes and restarts
+    if (roll < 3) return SIM_INPUT_JUMP;
+    if (roll < 6) return 0;
+
+    return (state->bird.y > nextGapBottom(state) - SIM_REAL(40)) ? SIM_INPUT_JUMP : 0;
+}
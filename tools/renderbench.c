@@ -0,0 +1,137 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "render.h"
+#include "atlas_rects.h"                // Generated by tools/assetpack.c
+
+//------------------------------------------------------------------------------------
+// Software Renderer Benchmark
+//
+// Plays a scripted session and renders every step, first as 84x84 grayscale
+// observations, then at the full 490x735 in RGBA, and reports frames per second.
+// With an output prefix it also writes the last frame of each as <prefix>.pgm and
+// <prefix>.ppm to look at.
+//
+// Usage: renderbench [frames] [threads] [output prefix]
+//------------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------------
+// Module Functions Declaration (local)
+//------------------------------------------------------------------------------------
+
+static double now(void);
+static unsigned int script(const SimState *state);                  // Flap under the next gap
+static double run(const RenderConfig *config, int frames, const char *path);    // Frames per second
+static void writeImage(const char *path, const unsigned char *pixels, const RenderConfig *config);
+
+//------------------------------------------------------------------------------------
+// Program Main Entry Point
+//------------------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    int frames = (argc > 1) ? atoi(argv[1]) : 20000;
+    int threads = (argc > 2) ? atoi(argv[2]) : 0;
+    const char *prefix = (argc > 3) ? argv[3] : NULL;
+    char path[256];
+
+    RenderConfig config = renderDefaultConfig();
+    config.threads = threads;
+
+    if (prefix != NULL) snprintf(path, sizeof(path), "%s.pgm", prefix);
+    double rate = run(&config, frames, prefix ? path : NULL);
+    if (rate < 0) return 1;
+    printf("%dx%d gray: %.0f frames/s\n", config.width, config.height, rate);
+
+    config.width = RENDER_SCREEN_WIDTH;
+    config.height = RENDER_SCREEN_HEIGHT;
+    config.format = RENDER_RGBA;
+
+    if (prefix != NULL) snprintf(path, sizeof(path), "%s.ppm", prefix);
+    rate = run(&config, frames / 10, prefix ? path : NULL);
+    if (rate < 0) return 1;
+    printf("%dx%d rgba: %.0f frames/s\n", config.width, config.height, rate);
+
+    return 0;
+}
+
+//------------------------------------------------------------------------------------
+// Benchmark Functions
+//------------------------------------------------------------------------------------
+
+double now(void)
+{
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+
+    return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+unsigned int script(const SimState *state)
+{
+    if (state->gameOver) return SIM_INPUT_RESTART;
+    if (!state->bird.isJumping) return SIM_INPUT_JUMP;
+
+    for (int n = 0; n < state->config.pipeCount; n++)
+    {
+        int i = (state->pipeNext + n) % state->config.pipeCount;
+        if (state->pipes.active[i]) return (state->bird.y > state->pipes.gapBottom[i] - SIM_REAL(40)) ? SIM_INPUT_JUMP : 0;
+    }
+
+    return 0;
+}
+
+double run(const RenderConfig *config, int frames, const char *path)
+{
+    Renderer *renderer = renderCreate(config, &assetPack.atlas, atlasRects);
+    unsigned char *pixels = malloc((size_t) config->width * config->height * 4);
+
+    if (renderer == NULL || pixels == NULL)
+    {
+        fprintf(stderr, "renderbench: could not create a %dx%d renderer\n", config->width, config->height);
+        return -1.0;
+    }
+
+    SimConfig simConfig = simDefaultConfig();
+    SimState state;
+    simInit(&state, &simConfig);
+
+    // Only the rendering is timed
+    double spent = 0.0;
+    for (int i = 0; i < frames; i++)
+    {
+        simStep(&state, script(&state), SIM_DT);
+
+        double start = now();
+        renderFrame(renderer, &state, pixels);
+        spent += now() - start;
+    }
+
+    if (path != NULL) writeImage(path, pixels, config);
+
+    free(pixels);
+    renderDestroy(renderer);
+
+    return frames / spent;
+}
+
+void writeImage(const char *path, const unsigned char *pixels, const RenderConfig *config)
+{
+    FILE *file = fopen(path, "wb");
+    if (file == NULL) return;
+
+    int count = config->width * config->height;
+
+    if (config->format == RENDER_GRAY)
+    {
+        fprintf(file, "P5\n%d %d\n255\n", config->width, config->height);
+        fwrite(pixels, 1, count, file);
+    }
+    else
+    {
+        fprintf(file, "P6\n%d %d\n255\n", config->width, config->height);
+        for (int i = 0; i < count; i++) fwrite(pixels + i * 4, 1, 3, file);
+    }
+
+    fclose(file);
+}
@@ -0,0 +1,62 @@
+#include <stdio.h>
+#include <time.h>
+#include "replay.h"
+
+//------------------------------------------------------------------------------------
+// Headless Replay Playback
+//
+// Re-simulates a recorded session as fast as the CPU allows and reports whether it
+// stayed in sync with the recording.
+//
+// Usage: replaycheck <replay>
+//------------------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    if (argc != 2)
+    {
+        fprintf(stderr, "Usage: %s <replay>\n", argv[0]);
+        return 1;
+    }
+
+    Replay *replay = replayLoad(argv[1]);
+    if (replay == NULL)
+    {
+        fprintf(stderr, "replaycheck: %s is not a replay\n", argv[1]);
+        return 1;
+    }
+
+    SimState state;
+    simInit(&state, replayConfig(replay));
+
+    int points = 0, hits = 0;
+    ReplayStatus status = REPLAY_PLAYING;
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    while (status == REPLAY_PLAYING)
+    {
+        int events = 0;
+        status = replayStep(replay, &state, &events);
+
+        if (events & SIM_EVENT_POINT) points++;
+        if (events & SIM_EVENT_HIT) hits++;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    double seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    double played = (double) replayTick(replay) / SIM_TICK_RATE;
+
+    printf("%d steps (%.1f s of play) in %.3f ms, %.0fx real time\n", replayTick(replay), played,
+           seconds * 1000.0, (seconds > 0) ? played / seconds : 0.0);
+    printf("%d points, %d crashes\n", points, hits);
+
+    if (status == REPLAY_DESYNC) printf("DESYNC within the second before step %d\n", replayTick(replay));
+    else printf("in sync\n");
+
+    replayDestroy(replay);
+
+    return (status == REPLAY_DESYNC) ? 2 : 0;
+}
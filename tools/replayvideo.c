@@ -0,0 +1,354 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "replay.h"
+#include "render.h"
+#include "workpool.h"
+#include "atlas_rects.h"                // Generated by tools/assetpack.c
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#endif
+
+//------------------------------------------------------------------------------------
+// Replay Video Export
+//
+// Re-simulates a recorded session headless and writes it as a raw YUV4MPEG2 video
+// (4:2:0, BT.601 studio range) that ffmpeg and most players read directly. While the
+// worker pool renders and converts batch n, the main thread simulates batch n + 1 and
+// writes batch n - 1, so three batches are in flight.
+//
+// Usage: replayvideo <replay> <output.y4m | -> [fps] [threads]
+//------------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------------
+// Defines Variables
+//------------------------------------------------------------------------------------
+
+#define VIDEO_FPS 60                    // Default frame rate, must divide SIM_TICK_RATE
+#define VIDEO_FRAMES_PER_THREAD 4       // Batch size per worker, each frame holds about 2 MB
+#define VIDEO_BATCHES 3                 // Simulating, encoding and writing
+
+//------------------------------------------------------------------------------------
+// Types and Structures Definition
+//------------------------------------------------------------------------------------
+
+typedef struct VideoFrame
+{
+    Renderer *renderer;                 // Shared, it has no threads of its own
+    SimState state;
+    unsigned char *rgba;                // Rendered frame
+    unsigned char *yuv;                 // Y, U and V planes, written as is
+
+} VideoFrame;
+
+typedef struct VideoBatch
+{
+    VideoFrame *frames;
+    int count;                          // Frames filled, 0 once the replay is over
+
+} VideoBatch;
+
+//------------------------------------------------------------------------------------
+// Module Functions Declaration (local)
+//------------------------------------------------------------------------------------
+
+static ReplayStatus simulateBatch(Replay *replay, SimState *state, VideoBatch *batch, int capacity, int stepsPerFrame);
+static void encodeFrame(void *arg);                                 // Render and convert one frame, a pool job
+static void convertFrame(const unsigned char *rgba, unsigned char *yuv, int width, int height);   // RGBA to planar 4:2:0
+static bool writeBatch(const VideoBatch *batch, size_t frameSize, FILE *file);
+
+//------------------------------------------------------------------------------------
+// Program Main Entry Point
+//------------------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    if (argc < 3)
+    {
+        fprintf(stderr, "Usage: %s <replay> <output.y4m | -> [fps] [threads]\n", argv[0]);
+        return 1;
+    }
+
+    int fps = (argc > 3) ? atoi(argv[3]) : VIDEO_FPS;
+    int threads = (argc > 4) ? atoi(argv[4]) : workPoolDefaultThreads();
+
+    if (fps < 1 || SIM_TICK_RATE % fps != 0)
+    {
+        fprintf(stderr, "replayvideo: the frame rate must divide %d\n", SIM_TICK_RATE);
+        return 1;
+    }
+    if (threads < 1) threads = 1;
+
+    Replay *replay = replayLoad(argv[1]);
+    if (replay == NULL)
+    {
+        fprintf(stderr, "replayvideo: %s is not a replay\n", argv[1]);
+        return 1;
+    }
+
+    FILE *file = (strcmp(argv[2], "-") == 0) ? stdout : fopen(argv[2], "wb");
+    if (file == NULL)
+    {
+        fprintf(stderr, "replayvideo: could not open %s\n", argv[2]);
+        return 1;
+    }
+
+    // Full-size RGBA frames, a single renderer shared by every worker
+    //------------------------------------------
+    RenderConfig config = renderDefaultConfig();
+    config.width = RENDER_SCREEN_WIDTH;
+    config.height = RENDER_SCREEN_HEIGHT;
+    config.format = RENDER_RGBA;
+
+    Renderer *renderer = renderCreate(&config, &assetPack.atlas, atlasRects);
+    WorkPool *pool = workPoolCreate(threads);
+
+    int capacity = threads * VIDEO_FRAMES_PER_THREAD;
+    size_t rgbaSize = (size_t) config.width * config.height * 4;
+    size_t frameSize = (size_t) config.width * config.height + 2 * (size_t) ((config.width + 1) / 2) * ((config.height + 1) / 2);
+
+    VideoBatch batches[VIDEO_BATCHES] = { 0 };
+    bool ok = (renderer != NULL) && (pool != NULL);
+
+    for (int b = 0; b < VIDEO_BATCHES && ok; b++)
+    {
+        batches[b].frames = calloc(capacity, sizeof(VideoFrame));
+        ok = (batches[b].frames != NULL);
+
+        for (int i = 0; i < capacity && ok; i++)
+        {
+            VideoFrame *frame = &batches[b].frames[i];
+            frame->renderer = renderer;
+            frame->rgba = malloc(rgbaSize);
+            frame->yuv = malloc(frameSize);
+            ok = (frame->rgba != NULL) && (frame->yuv != NULL);
+        }
+    }
+
+    if (!ok)
+    {
+        fprintf(stderr, "replayvideo: out of memory\n");
+        return 1;
+    }
+
+    fprintf(file, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C420jpeg\n", config.width, config.height, fps);
+
+    // Pipeline: hand batch n to the workers, then simulate batch n + 1 and write batch
+    // n - 1 before waiting for them
+    //------------------------------------------
+    SimState state;
+    simInit(&state, replayConfig(replay));
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    ReplayStatus status = simulateBatch(replay, &state, &batches[0], capacity, SIM_TICK_RATE / fps);
+    VideoBatch *simulated = &batches[0];    // Simulated, not encoded yet
+    const VideoBatch *ready = NULL;         // Encoded, not written yet
+    int frames = 0;
+    bool written = true;
+
+    for (int n = 1; ; n++)
+    {
+        VideoBatch *encoding = simulated;
+        for (int i = 0; i < encoding->count; i++) workPoolSubmit(pool, encodeFrame, &encoding->frames[i]);
+
+        simulated = &batches[n % VIDEO_BATCHES];
+        simulated->count = 0;
+        if (status == REPLAY_PLAYING) status = simulateBatch(replay, &state, simulated, capacity, SIM_TICK_RATE / fps);
+
+        if (ready != NULL) written = written && writeBatch(ready, frameSize, file);
+        workPoolWait(pool);
+
+        frames += encoding->count;
+        ready = encoding;
+
+        if (encoding->count == 0) break;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    if (file != stdout) written = (fclose(file) == 0) && written;
+    else written = (fflush(file) == 0) && written;
+
+    double seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    double played = (double) replayTick(replay) / SIM_TICK_RATE;
+
+    fprintf(stderr, "%d frames (%.1f s of play) in %.3f s, %.0f frames/s, %.1fx real time\n", frames, played,
+            seconds, (seconds > 0) ? frames / seconds : 0.0, (seconds > 0) ? played / seconds : 0.0);
+    if (status == REPLAY_DESYNC) fprintf(stderr, "DESYNC within the second before step %d, the video stops there\n", replayTick(replay));
+    if (!written) fprintf(stderr, "replayvideo: could not write %s\n", argv[2]);
+
+    workPoolDestroy(pool);
+    for (int b = 0; b < VIDEO_BATCHES; b++)
+    {
+        for (int i = 0; i < capacity; i++)
+        {
+            free(batches[b].frames[i].rgba);
+            free(batches[b].frames[i].yuv);
+        }
+        free(batches[b].frames);
+    }
+    renderDestroy(renderer);
+    replayDestroy(replay);
+
+    if (!written) return 1;
+
+    return (status == REPLAY_DESYNC) ? 2 : 0;
+}
+
+//------------------------------------------------------------------------------------
+// Pipeline Functions
+//------------------------------------------------------------------------------------
+
+ReplayStatus simulateBatch(Replay *replay, SimState *state, VideoBatch *batch, int capacity, int stepsPerFrame)
+{
+    ReplayStatus status = REPLAY_PLAYING;
+
+    // A frame shows the state after its last step, a replay ending mid-frame still gets one
+    while (batch->count < capacity && status == REPLAY_PLAYING)
+    {
+        int steps = 0;
+        while (steps < stepsPerFrame)
+        {
+            status = replayStep(replay, state, NULL);
+            if (status != REPLAY_ENDED) steps++;                    // Ended returns without stepping
+            if (status != REPLAY_PLAYING) break;
+        }
+
+        if (status == REPLAY_DESYNC || steps == 0) break;           // Diverged frames are not shown
+
+        batch->frames[batch->count++].state = *state;
+    }
+
+    return status;
+}
+
+void encodeFrame(void *arg)
+{
+    VideoFrame *frame = arg;
+
+    renderFrame(frame->renderer, &frame->state, frame->rgba);
+    convertFrame(frame->rgba, frame->yuv, RENDER_SCREEN_WIDTH, RENDER_SCREEN_HEIGHT);
+}
+
+bool writeBatch(const VideoBatch *batch, size_t frameSize, FILE *file)
+{
+    for (int i = 0; i < batch->count; i++)
+    {
+        if (fputs("FRAME\n", file) == EOF) return false;
+        if (fwrite(batch->frames[i].yuv, 1, frameSize, file) != frameSize) return false;
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------
+// Colour Conversion (BT.601, studio range, chroma averaged over 2x2 pixels)
+//------------------------------------------------------------------------------------
+
+void convertFrame(const unsigned char *rgba, unsigned char *yuv, int width, int height)
+{
+    const int chromaWidth = (width + 1) / 2, chromaHeight = (height + 1) / 2;
+    unsigned char *uPlane = yuv + (size_t) width * height;
+    unsigned char *vPlane = uPlane + (size_t) chromaWidth * chromaHeight;
+
+    // One pass over each pair of rows while they are in cache, an odd last row or column pairs with itself
+    for (int cy = 0; cy < chromaHeight; cy++)
+    {
+        const int rows = (2 * cy + 1 < height) ? 2 : 1;
+        const unsigned char *line[2] = { rgba + (size_t) (2 * cy) * width * 4, rgba + (size_t) (2 * cy + rows - 1) * width * 4 };
+        unsigned char *luma[2] = { yuv + (size_t) (2 * cy) * width, yuv + (size_t) (2 * cy + rows - 1) * width };
+        unsigned char *u = uPlane + (size_t) cy * chromaWidth;
+        unsigned char *v = vPlane + (size_t) cy * chromaWidth;
+        int cx = 0;
+
+#if defined(__SSE2__)
+        // 8 pixels of both rows per step: madd gives R and G, and B, as adjacent 32-bit lanes,
+        // which the even/odd lane shuffles then add up per pixel
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i lumaWeights = _mm_setr_epi16(66, 129, 25, 0, 66, 129, 25, 0);
+        const __m128i uWeights = _mm_setr_epi16(-38, -74, 112, 0, -38, -74, 112, 0);
+        const __m128i vWeights = _mm_setr_epi16(112, -94, -18, 0, 112, -94, -18, 0);
+
+        #define SUM_PAIRS(a, b) _mm_add_epi32(                                                                  \
+            _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b), _MM_SHUFFLE(2, 0, 2, 0))),   \
+            _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b), _MM_SHUFFLE(3, 1, 3, 1))))
+
+        for (; 2 * cx + 8 <= width; cx += 4)
+        {
+            __m128i blocks01 = zero, blocks23 = zero;   // Two 2x2 sums per register, R G B A in 16-bit lanes
+
+            for (int j = 0; j < rows; j++)
+            {
+                __m128i left = _mm_loadu_si128((const __m128i *) (line[j] + 8 * cx));
+                __m128i right = _mm_loadu_si128((const __m128i *) (line[j] + 8 * cx + 16));
+                __m128i pixels01 = _mm_unpacklo_epi8(left, zero), pixels23 = _mm_unpackhi_epi8(left, zero);
+                __m128i pixels45 = _mm_unpacklo_epi8(right, zero), pixels67 = _mm_unpackhi_epi8(right, zero);
+
+                __m128i low = SUM_PAIRS(_mm_madd_epi16(pixels01, lumaWeights), _mm_madd_epi16(pixels23, lumaWeights));
+                __m128i high = SUM_PAIRS(_mm_madd_epi16(pixels45, lumaWeights), _mm_madd_epi16(pixels67, lumaWeights));
+                low = _mm_srai_epi32(_mm_add_epi32(low, _mm_set1_epi32(128)), 8);
+                high = _mm_srai_epi32(_mm_add_epi32(high, _mm_set1_epi32(128)), 8);
+
+                __m128i values = _mm_add_epi16(_mm_packs_epi32(low, high), _mm_set1_epi16(16));
+                _mm_storel_epi64((__m128i *) (luma[j] + 2 * cx), _mm_packus_epi16(values, values));
+
+                // Left plus right pixel of each block, then the blocks side by side
+                __m128i sum01 = _mm_add_epi16(pixels01, _mm_srli_si128(pixels01, 8));
+                __m128i sum23 = _mm_add_epi16(pixels23, _mm_srli_si128(pixels23, 8));
+                __m128i sum45 = _mm_add_epi16(pixels45, _mm_srli_si128(pixels45, 8));
+                __m128i sum67 = _mm_add_epi16(pixels67, _mm_srli_si128(pixels67, 8));
+                blocks01 = _mm_add_epi16(blocks01, _mm_unpacklo_epi64(sum01, sum23));
+                blocks23 = _mm_add_epi16(blocks23, _mm_unpacklo_epi64(sum45, sum67));
+            }
+
+            if (rows == 1)                              // The last row of an odd height counts twice
+            {
+                blocks01 = _mm_add_epi16(blocks01, blocks01);
+                blocks23 = _mm_add_epi16(blocks23, blocks23);
+            }
+
+            __m128i uSum = SUM_PAIRS(_mm_madd_epi16(blocks01, uWeights), _mm_madd_epi16(blocks23, uWeights));
+            __m128i vSum = SUM_PAIRS(_mm_madd_epi16(blocks01, vWeights), _mm_madd_epi16(blocks23, vWeights));
+            uSum = _mm_srai_epi32(_mm_add_epi32(uSum, _mm_set1_epi32(512)), 10);
+            vSum = _mm_srai_epi32(_mm_add_epi32(vSum, _mm_set1_epi32(512)), 10);
+
+            __m128i chroma = _mm_add_epi16(_mm_packs_epi32(uSum, vSum), _mm_set1_epi16(128));
+            chroma = _mm_packus_epi16(chroma, chroma);
+
+            int uBytes = _mm_cvtsi128_si32(chroma), vBytes = _mm_cvtsi128_si32(_mm_srli_si128(chroma, 4));
+            memcpy(u + cx, &uBytes, 4);
+            memcpy(v + cx, &vBytes, 4);
+        }
+
+        #undef SUM_PAIRS
+#endif
+
+        for (; cx < chromaWidth; cx++)
+        {
+            const int columns = (2 * cx + 1 < width) ? 2 : 1;
+            int r = 0, g = 0, b = 0;
+
+            for (int j = 0; j < 2; j++)
+            {
+                for (int i = 0; i < 2; i++)
+                {
+                    int x = 2 * cx + ((i < columns) ? i : 0);
+                    const unsigned char *pixel = line[j] + x * 4;
+
+                    luma[j][x] = (unsigned char) (16 + ((66 * pixel[0] + 129 * pixel[1] + 25 * pixel[2] + 128) >> 8));
+                    r += pixel[0];
+                    g += pixel[1];
+                    b += pixel[2];
+                }
+            }
+
+            // Sums of four pixels, so the usual weights shift by two more bits
+            u[cx] = (unsigned char) (128 + ((-38 * r - 74 * g + 112 * b + 512) >> 10));
+            v[cx] = (unsigned char) (128 + ((112 * r - 94 * g - 18 * b + 512) >> 10));
+        }
+    }
+}
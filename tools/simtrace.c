@@ -0,0 +1,131 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "population.h"
+
+//------------------------------------------------------------------------------------
+// Golden State Trace
+//
+// Plays a scripted session on the single-bird path and a scripted population on the
+// same course, and prints a hash of both once per simulated second. Two builds agree
+// on the simulation exactly when their traces are identical, so diff the output of
+// e.g. a GCC -O0 and a Clang -O3 build. Fixed-point builds (FLAPPY_FIXED_POINT) are
+// expected to match everywhere; float builds only while compilers make the same
+// rounding choices. The simtrace_fixed and simtrace_float tests check a build
+// against tests/simtrace_fixed.golden or tests/simtrace_float.golden.
+//
+// Usage: simtrace [seconds]
+//------------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------------
+// Defines Variables
+//------------------------------------------------------------------------------------
+
+#define TRACE_BIRDS 1000                // Population size, enough to cover every kernel lane count
+
+//------------------------------------------------------------------------------------
+// Module Functions Declaration (local)
+//------------------------------------------------------------------------------------
+
+static SimReal nextGapBottom(const SimState *state);                // Bottom of the first gap not passed yet
+static unsigned int script(const SimState *state, SimRng *rng);     // Flap under the gap, with random slips
+static uint32_t hashPopulation(const Population *pop);              // World hash folded with every live bird
+
+//------------------------------------------------------------------------------------
+// Program Main Entry Point
+//------------------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    int seconds = (argc > 1) ? atoi(argv[1]) : 600;
+
+    SimConfig config = simDefaultConfig();
+    config.seed = 2024;
+
+    SimState game;
+    simInit(&game, &config);
+
+    Population *pop = populationCreate(TRACE_BIRDS);
+    if (pop == NULL) return 1;
+    populationReset(pop, &config, TRACE_BIRDS);
+
+    unsigned char *flap = malloc(TRACE_BIRDS);
+    if (flap == NULL) return 1;
+
+    SimRng rng;
+    simRngSeed(&rng, 7, 0);
+
+    printf("second single population\n");
+
+    for (int second = 1; second <= seconds; second++)
+    {
+        for (int tick = 0; tick < SIM_TICK_RATE; tick++)
+        {
+            simStep(&game, script(&game, &rng), SIM_DT);
+
+            // Every bird aims a different height above the bottom pipe, a new course once all are down
+            if (pop->alive == 0) populationReset(pop, &config, TRACE_BIRDS);
+
+            SimReal gapBottom = nextGapBottom(&pop->world);
+            for (int i = 0; i < pop->alive; i++)
+            {
+                int bird = pop->id[i];
+                flap[bird] = pop->y[i] > gapBottom - SIM_REAL(20) - simFromInt(bird * 37 % 101);
+            }
+
+            populationStep(pop, flap, SIM_DT);
+        }
+
+        printf("%d %08x %08x\n", second, simHash(&game), hashPopulation(pop));
+    }
+
+    free(flap);
+    populationDestroy(pop);
+
+    return 0;
+}
+
+//------------------------------------------------------------------------------------
+// Script Functions
+//------------------------------------------------------------------------------------
+
+SimReal nextGapBottom(const SimState *state)
+{
+    for (int n = 0; n < state->config.pipeCount; n++)
+    {
+        int i = (state->pipeNext + n) % state->config.pipeCount;
+        if (state->pipes.active[i]) return state->pipes.gapBottom[i];
+    }
+
+    return state->map.ground;
+}
+
+unsigned int script(const SimState *state, SimRng *rng)
+{
+    uint32_t roll = simRngRange(rng, 1000);
+
+    if (state->gameOver) return (roll < 20) ? SIM_INPUT_RESTART : 0;
+    if (!state->bird.isJumping) return (roll < 50) ? SIM_INPUT_JUMP : 0;
+
+    // Mostly hold under the gap, now and then slip so the session also crashes and restarts
+    if (roll < 3) return SIM_INPUT_JUMP;
+    if (roll < 6) return 0;
+
+    return (state->bird.y > nextGapBottom(state) - SIM_REAL(40)) ? SIM_INPUT_JUMP : 0;
+}
+
+uint32_t hashPopulation(const Population *pop)
+{
+    uint32_t hash = simHash(&pop->world);
+
+    for (int i = 0; i < pop->alive; i++)
+    {
+        uint32_t word;
+        memcpy(&word, &pop->y[i], sizeof(word));
+
+        hash = (hash ^ word) * 16777619u;
+        hash = (hash ^ (uint32_t) pop->id[i]) * 16777619u;
+    }
+
+    return hash;
+}
@@ -0,0 +1,188 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "sim.h"
+
+//------------------------------------------------------------------------------------
+// Flap Trajectory Table Generator
+//
+// Build-time tool: integrates the bird's arc after a flap with the same operations as
+// jump(), writes it as a table with inverse lookups for gap checks, then replays the
+// arc through simStep from every height the bird can flap at and fails the build if
+// the table drifts from the live integration.
+//
+// Usage: trajgen <trajectory_table.h>
+//------------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------------
+// Defines Variables
+//------------------------------------------------------------------------------------
+
+#define TRAJ_MAX_TICKS 1024             // Hard limit on the table length
+#define TRAJ_MAX_DROP 1000.0f           // Stop once the bird has fallen further than any screen
+#define TRAJ_TOLERANCE 0.01f            // Largest accepted difference from simStep, in pixels (0 for fixed point)
+
+//------------------------------------------------------------------------------------
+// Module Functions Declaration (local)
+//------------------------------------------------------------------------------------
+
+static int integrate(SimReal gravity, SimReal *offset);                     // Fill offsets, returns the tick count
+static float validate(const SimReal *offset, int count);                    // Largest difference from simStep
+static int writeTable(const char *path, const SimReal *offset, int count, float error);
+
+//------------------------------------------------------------------------------------
+// Program Main Entry Point
+//------------------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    static SimReal offset[TRAJ_MAX_TICKS];
+
+    if (argc != 2)
+    {
+        fprintf(stderr, "Usage: %s <trajectory_table.h>\n", argv[0]);
+        return 1;
+    }
+
+    SimConfig config = simDefaultConfig();
+    SimState state;
+    simInit(&state, &config);
+
+    int count = integrate(state.bird.gravity, offset);
+    float error = validate(offset, count);
+
+#if defined(SIM_FIXED_POINT)
+    if (error > 0.0f)
+#else
+    if (error > TRAJ_TOLERANCE)
+#endif
+    {
+        fprintf(stderr, "trajgen: table differs from simStep by %g px (limit %g)\n", error, TRAJ_TOLERANCE);
+        return 1;
+    }
+
+    return writeTable(argv[1], offset, count, error);
+}
+
+//------------------------------------------------------------------------------------
+// Table Functions
+//------------------------------------------------------------------------------------
+
+int integrate(SimReal gravity, SimReal *offset)
+{
+    const SimReal dt = simFromFloat(SIM_DT);
+    SimReal acceleration = SIM_REAL(10);
+    SimReal velocity = simDiv(-gravity, SIM_REAL(1.5));
+    SimReal y = SIM_REAL(0);
+    int count = 1;
+
+    offset[0] = SIM_REAL(0);
+
+    // Step 1 is the flap itself, every later step only falls
+    for (int k = 1; k < TRAJ_MAX_TICKS; k++)
+    {
+        if (k > 1) acceleration += simMul(gravity, dt);
+        if (acceleration >= gravity) acceleration = gravity;
+
+        velocity += simMul(acceleration, dt) * 10;
+        y += simMul(velocity, dt) * 5;
+
+        offset[k] = y;
+        count = k + 1;
+
+        if (y > SIM_REAL(TRAJ_MAX_DROP)) break;
+    }
+
+    return count;
+}
+
+float validate(const SimReal *offset, int count)
+{
+    SimConfig config = simDefaultConfig();
+    SimState state;
+    float error = 0.0f;
+
+    simInit(&state, &config);
+
+    // Every height between ceiling and ground, at a step that doesn't land on whole pixels
+    for (SimReal start = state.map.ceiling + SIM_REAL(0.5); start < state.map.ground; start += SIM_REAL(0.37))
+    {
+        simInit(&state, &config);
+        for (int i = 0; i < config.pipeCount; i++) state.pipes.x[i] = SIM_REAL(30000);  // Nothing to hit but the bounds
+
+        state.bird.y = start;
+        state.bird.isJumping = 1;
+
+        for (int k = 1; k < count; k++)
+        {
+            simStep(&state, (k == 1) ? SIM_INPUT_JUMP : 0, SIM_DT);
+            if (state.gameOver) break;
+
+            float difference = fabsf(simToFloat((state.bird.y - start) - offset[k]));
+            if (difference > error) error = difference;
+        }
+    }
+
+    return error;
+}
+
+int writeTable(const char *path, const SimReal *offset, int count, float error)
+{
+    FILE *outFile = fopen(path, "w");
+    if (outFile == NULL)
+    {
+        fprintf(stderr, "trajgen: could not write %s\n", path);
+        return 1;
+    }
+
+    int apex = 0;
+    for (int k = 1; k < count; k++) if (offset[k] < offset[apex]) apex = k;
+
+    // Inverse lookups over whole-pixel thresholds v, from floor(apex offset) upwards:
+    // rise[v] is the first tick up to the apex with offset < v, fall[v] the first tick
+    // from the apex on with offset > v
+    int base = (int) floorf(simToFloat(offset[apex]));
+    int riseCount = 0 - base + 1;
+    int fallCount = (int) ceilf(simToFloat(offset[count - 1])) - base + 1;
+
+    fprintf(outFile, "// Generated by tools/trajgen.c, do not edit\n");
+    fprintf(outFile, "// Largest difference from simStep over every flap height: %g px\n\n", error);
+    fprintf(outFile, "#define TRAJ_TICK_RATE %d\n", SIM_TICK_RATE);
+    fprintf(outFile, "#define TRAJ_TICKS %d\n#define TRAJ_APEX %d\n#define TRAJ_BASE %d\n", count, apex, base);
+    fprintf(outFile, "#define TRAJ_RISE_COUNT %d\n#define TRAJ_FALL_COUNT %d\n\n", riseCount, fallCount);
+
+    // Hex floats or raw Q16.16, so the offsets round-trip bit for bit
+    fprintf(outFile, "static const SimReal trajOffsets[TRAJ_TICKS] =\n{\n");
+    for (int k = 0; k < count; k++)
+    {
+#if defined(SIM_FIXED_POINT)
+        fprintf(outFile, (k % 8 == 7) ? "%d,\n" : "%d, ", (int) offset[k]);
+#else
+        fprintf(outFile, (k % 4 == 3) ? "%af,\n" : "%af, ", offset[k]);
+#endif
+    }
+    fprintf(outFile, "\n};\n\n");
+
+    fprintf(outFile, "static const unsigned short trajRise[TRAJ_RISE_COUNT] =\n{\n");
+    for (int i = 0; i < riseCount; i++)
+    {
+        SimReal v = simFromInt(base + i);
+        int k = 0;
+        while (k < apex && !(offset[k] < v)) k++;
+        fprintf(outFile, (i % 16 == 15) ? "%d,\n" : "%d, ", k);
+    }
+    fprintf(outFile, "\n};\n\n");
+
+    fprintf(outFile, "static const unsigned short trajFall[TRAJ_FALL_COUNT] =\n{\n");
+    for (int i = 0; i < fallCount; i++)
+    {
+        SimReal v = simFromInt(base + i);
+        int k = apex;
+        while (k < count - 1 && !(offset[k] > v)) k++;
+        fprintf(outFile, (i % 16 == 15) ? "%d,\n" : "%d, ", k);
+    }
+    fprintf(outFile, "\n};\n");
+
+    fclose(outFile);
+    return 0;
+}
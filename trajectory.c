@@ -0,0 +1,81 @@
+#include "trajectory.h"
+#include "trajectory_table.h"           // Generated by tools/trajgen.c
+
+//------------------------------------------------------------------------------------
+// Module Functions Declaration (local)
+//------------------------------------------------------------------------------------
+
+static int firstBelow(SimReal limit);   // First tick up to the apex with offset < limit, TRAJ_TICKS if none
+static int firstAbove(SimReal limit);   // First tick from the apex on with offset > limit, TRAJ_TICKS if none
+
+//------------------------------------------------------------------------------------
+// Trajectory Functions
+//------------------------------------------------------------------------------------
+
+SimReal trajOffset(int ticks)
+{
+    if (ticks <= 0) return SIM_REAL(0);
+    if (ticks >= TRAJ_TICKS) return trajOffsets[TRAJ_TICKS - 1];   // Far below the ground by then
+
+    return trajOffsets[ticks];
+}
+
+int trajApex(void)
+{
+    return TRAJ_APEX;
+}
+
+int trajFirstHit(SimReal flapY, int from, int to, SimBand band, SimReal birdHeight)
+{
+    if (from < 0) from = 0;
+    if (to < from) return -1;
+
+    // Same hitbox as the step: top at y - birdHeight + 15, bottom at y + 5. Only the gap
+    // edges matter, the pipes' far ends are off screen.
+    SimReal topLimit = band.top + birdHeight - SIM_REAL(15) - flapY;    // Hit while offset < topLimit
+    SimReal bottomLimit = band.bottom - SIM_REAL(5) - flapY;            // Hit while offset > bottomLimit
+
+    SimReal offset = trajOffset(from);
+    if (offset < topLimit || offset > bottomLimit) return from;
+
+    // Inside the gap at from: the top can only be crossed while rising, the bottom while falling
+    int hit = firstAbove(bottomLimit);
+    if (from < TRAJ_APEX)
+    {
+        int rise = firstBelow(topLimit);
+        if (rise < hit) hit = rise;
+    }
+
+    return (hit <= to && hit < TRAJ_TICKS) ? hit : -1;
+}
+
+//------------------------------------------------------------------------------------
+// Inverse Lookups (whole-pixel table entry, then a few ticks to the exact crossing)
+//------------------------------------------------------------------------------------
+
+int firstBelow(SimReal limit)
+{
+    if (limit > SIM_REAL(0)) return 0;
+    if (limit <= trajOffsets[TRAJ_APEX]) return TRAJ_TICKS;
+
+    int pixel = simToInt(limit);                                    // Rounds up, limit is negative
+    int k = trajRise[pixel - TRAJ_BASE];
+
+    while (trajOffsets[k] >= limit) k++;                            // Stops at the apex at the latest
+
+    return k;
+}
+
+int firstAbove(SimReal limit)
+{
+    if (limit < trajOffsets[TRAJ_APEX]) return TRAJ_APEX;
+    if (limit >= trajOffsets[TRAJ_TICKS - 1]) return TRAJ_TICKS;
+
+    int pixel = simToInt(limit);
+    if (simFromInt(pixel) > limit) pixel--;                         // Rounds down
+    int k = trajFall[pixel - TRAJ_BASE];
+
+    while (trajOffsets[k] <= limit) k++;                            // Stops at the last tick at the latest
+
+    return k;
+}
@@ -0,0 +1,29 @@
+#ifndef TRAJECTORY_H
+#define TRAJECTORY_H
+
+#include "sim.h"
+
+//------------------------------------------------------------------------------------
+// Flap Trajectory Tables
+//
+// A flap resets the bird's velocity and acceleration, so its height from then on is
+// the height it flapped at plus an offset that only depends on the steps since the
+// flap. The offsets are generated at build time by tools/trajgen.c, which checks them
+// against simStep. Tick k is the bird's y after k steps, the flap being step 1, and
+// is the y that step k + 1 tests for collisions.
+//
+// The arc rises to an apex and then falls, so a gap can only be left through its top
+// before the apex and through its bottom after it. Inverse tables give the first
+// tick either happens, which makes a gap check a couple of lookups, not a loop.
+// The tables hold for the default gravity at SIM_TICK_RATE.
+//------------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------------
+// Module Functions Declaration
+//------------------------------------------------------------------------------------
+
+SimReal trajOffset(int ticks);                                      // Height change `ticks` steps after a flap
+int trajApex(void);                                                 // Tick of the highest point
+int trajFirstHit(SimReal flapY, int from, int to, SimBand band, SimReal birdHeight);    // First tick in [from, to] the hitbox leaves the gap, -1 if never
+
+#endif // TRAJECTORY_H
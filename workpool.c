@@ -0,0 +1,161 @@
+#include <stdlib.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "workpool.h"
+
+//------------------------------------------------------------------------------------
+// Types and Structures Definition
+//------------------------------------------------------------------------------------
+
+typedef struct WorkJob
+{
+    WorkFunc func;
+    void *arg;
+    struct WorkJob *next;
+
+} WorkJob;
+
+struct WorkPool
+{
+    pthread_mutex_t lock;
+    pthread_cond_t jobReady;            // Signalled when a job is queued or the pool shuts down
+    pthread_cond_t allDone;             // Signalled when the last pending job finishes
+
+    WorkJob *head, *tail;
+    int pending;                        // Queued plus running jobs
+    bool quit;
+
+    int threadCount;
+    pthread_t *threads;
+};
+
+//------------------------------------------------------------------------------------
+// Module Functions Declaration (local)
+//------------------------------------------------------------------------------------
+
+static void *workerMain(void *arg);     // Worker thread loop
+
+//------------------------------------------------------------------------------------
+// Pool Functions
+//------------------------------------------------------------------------------------
+
+int workPoolDefaultThreads(void)
+{
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+
+    return (cores > 1) ? (int) cores - 1 : 1;
+}
+
+WorkPool *workPoolCreate(int threads)
+{
+    WorkPool *pool = calloc(1, sizeof(WorkPool));
+    if (pool == NULL) return NULL;
+
+    if (threads < 1) threads = 1;
+
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->jobReady, NULL);
+    pthread_cond_init(&pool->allDone, NULL);
+
+    pool->threads = malloc(threads * sizeof(pthread_t));
+    for (int i = 0; (pool->threads != NULL) && (i < threads); i++)
+    {
+        if (pthread_create(&pool->threads[i], NULL, workerMain, pool) != 0) break;
+        pool->threadCount++;
+    }
+
+    // Without a single worker, queued jobs would never run and workPoolWait would block forever
+    if (pool->threadCount == 0)
+    {
+        workPoolDestroy(pool);
+        return NULL;
+    }
+
+    return pool;
+}
+
+void workPoolSubmit(WorkPool *pool, WorkFunc func, void *arg)
+{
+    WorkJob *job = (pool != NULL) ? malloc(sizeof(WorkJob)) : NULL;
+
+    // No pool, or no memory to queue the job: run it here, it is done before the call returns
+    if (job == NULL)
+    {
+        func(arg);
+        return;
+    }
+
+    job->func = func;
+    job->arg = arg;
+    job->next = NULL;
+
+    pthread_mutex_lock(&pool->lock);
+    if (pool->tail != NULL) pool->tail->next = job;
+    else pool->head = job;
+    pool->tail = job;
+    pool->pending++;
+    pthread_cond_signal(&pool->jobReady);
+    pthread_mutex_unlock(&pool->lock);
+}
+
+void workPoolWait(WorkPool *pool)
+{
+    if (pool == NULL) return;
+
+    pthread_mutex_lock(&pool->lock);
+    while (pool->pending > 0) pthread_cond_wait(&pool->allDone, &pool->lock);
+    pthread_mutex_unlock(&pool->lock);
+}
+
+void workPoolDestroy(WorkPool *pool)
+{
+    if (pool == NULL) return;
+
+    workPoolWait(pool);
+
+    pthread_mutex_lock(&pool->lock);
+    pool->quit = true;
+    pthread_cond_broadcast(&pool->jobReady);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (int i = 0; i < pool->threadCount; i++) pthread_join(pool->threads[i], NULL);
+
+    pthread_cond_destroy(&pool->allDone);
+    pthread_cond_destroy(&pool->jobReady);
+    pthread_mutex_destroy(&pool->lock);
+
+    free(pool->threads);
+    free(pool);
+}
+
+//------------------------------------------------------------------------------------
+// Worker Thread
+//------------------------------------------------------------------------------------
+
+void *workerMain(void *arg)
+{
+    WorkPool *pool = arg;
+
+    pthread_mutex_lock(&pool->lock);
+    for (;;)
+    {
+        while (pool->head == NULL && !pool->quit) pthread_cond_wait(&pool->jobReady, &pool->lock);
+        if (pool->head == NULL) break;
+
+        WorkJob *job = pool->head;
+        pool->head = job->next;
+        if (pool->head == NULL) pool->tail = NULL;
+
+        pthread_mutex_unlock(&pool->lock);
+        job->func(job->arg);
+        free(job);
+        pthread_mutex_lock(&pool->lock);
+
+        pool->pending--;
+        if (pool->pending == 0) pthread_cond_broadcast(&pool->allDone);
+    }
+    pthread_mutex_unlock(&pool->lock);
+
+    return NULL;
+}
@@ -0,0 +1,32 @@
+#ifndef WORKPOOL_H
+#define WORKPOOL_H
+
+//------------------------------------------------------------------------------------
+// Worker Thread Pool
+//
+// A fixed set of threads pulling jobs from one FIFO queue. Meant for coarse jobs
+// (asset preparation, search subtrees, render tiles), not for per-step work.
+//
+// workPoolCreate returns NULL when no worker thread could be started. Submitting to a
+// NULL pool runs the job on the calling thread, so callers may fall back to it.
+//------------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------------
+// Types and Structures Definition
+//------------------------------------------------------------------------------------
+
+typedef void (*WorkFunc)(void *arg);
+
+typedef struct WorkPool WorkPool;
+
+//------------------------------------------------------------------------------------
+// Module Functions Declaration
+//------------------------------------------------------------------------------------
+
+int workPoolDefaultThreads(void);                                   // Online cores minus the main thread, at least 1
+WorkPool *workPoolCreate(int threads);                              // Start the worker threads, NULL if none started
+void workPoolSubmit(WorkPool *pool, WorkFunc func, void *arg);      // Queue a job; without a pool it runs before returning
+void workPoolWait(WorkPool *pool);                                  // Block until every queued job has finished
+void workPoolDestroy(WorkPool *pool);                               // Finish queued jobs and join the threads
+
+#endif // WORKPOOL_H